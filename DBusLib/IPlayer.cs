@@ -22,6 +22,7 @@ namespace Muine.DBusLib
 		void PlayAlbum (uint time);
 		void PlaySong (uint time);
 		void OpenPlaylist (string uri);
+		uint GetPlaylistVersion ();
 		void PlayFile (string uri);
 		void QueueFile (string uri);
 		// XXX: Should be uri
@@ -135,6 +135,11 @@ namespace Muine.DBusLib
 			player.OpenPlaylist (uri);
 		}
 
+		public virtual uint GetPlaylistVersion ()
+		{
+			return player.PlaylistVersion;
+		}
+
 		public virtual void PlayFile (string uri)
 		{
 			player.PlayFile (uri);
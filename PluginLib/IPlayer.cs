@@ -60,6 +60,10 @@ namespace Muine.PluginLib
 			get;
 		}
 
+		uint PlaylistVersion {
+			get;
+		}
+
 		ISong [] Selection {
 			get;
 		}
@@ -109,6 +113,8 @@ namespace Muine.PluginLib
 		void SyncSong (ISong song);
 		void RemoveSong (string path);
 		void RemoveSong (ISong song);
+		void MoveSong (string old_path, string new_path);
+		void MoveFolder (string old_folder, string new_folder);
 
 		event SongChangedEventHandler SongChangedEvent;
 	
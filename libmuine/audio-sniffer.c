@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Tells music files from files that only have a music extension, by the
+ * first few bytes: videos, HTML pages saved as .mp3, truncated downloads.
+ * Those would otherwise only be found out by the tag reader, after a
+ * full parse and an exception.
+ *
+ * Only formats we know the signature of are judged; for the others, and
+ * whenever we can't read the file, the answer is AUDIO_SNIFF_UNKNOWN.
+ * Where a signature is ambiguous we rather let a file through than
+ * reject a good one.
+ */
+
+#include <config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib.h>
+
+#include "audio-sniffer.h"
+
+#define SNIFF_SIZE 4096
+
+typedef enum {
+	FORMAT_UNKNOWN,
+	FORMAT_MPEG,
+	FORMAT_FLAC,
+	FORMAT_OGG,
+	FORMAT_MP4,
+	FORMAT_WAVPACK
+} Format;
+
+static const struct {
+	const char *extension;
+	Format      format;
+} formats[] = {
+	{ "mp3",  FORMAT_MPEG    },
+	{ "mp2",  FORMAT_MPEG    },
+	{ "aac",  FORMAT_MPEG    }, /* ADTS shares the MPEG frame sync */
+	{ "flac", FORMAT_FLAC    },
+	{ "ogg",  FORMAT_OGG     },
+	{ "oga",  FORMAT_OGG     },
+	{ "spx",  FORMAT_OGG     },
+	{ "opus", FORMAT_OGG     },
+	{ "m4a",  FORMAT_MP4     },
+	{ "m4b",  FORMAT_MP4     },
+	{ "m4p",  FORMAT_MP4     },
+	{ "mp4",  FORMAT_MP4     },
+	{ "wv",   FORMAT_WAVPACK },
+	{ NULL,   FORMAT_UNKNOWN }
+};
+
+static Format
+format_from_filename (const char *filename)
+{
+	const char *ext;
+	int i;
+
+	ext = strrchr (filename, '.');
+	if (ext == NULL)
+		return FORMAT_UNKNOWN;
+
+	ext++;
+
+	for (i = 0; formats[i].extension != NULL; i++) {
+		if (g_ascii_strcasecmp (ext, formats[i].extension) == 0)
+			return formats[i].format;
+	}
+
+	return FORMAT_UNKNOWN;
+}
+
+/* Size of the ID3v2 tag at the start of buf, or 0 if there is none */
+static gsize
+id3v2_size (const guchar *buf, gsize len)
+{
+	gsize size;
+
+	if (len < 10 || memcmp (buf, "ID3", 3) != 0)
+		return 0;
+
+	/* Sync-safe: 7 bits per byte */
+	if ((buf[6] | buf[7] | buf[8] | buf[9]) & 0x80)
+		return 0;
+
+	size = (buf[6] << 21) | (buf[7] << 14) | (buf[8] << 7) | buf[9];
+	size += 10;
+
+	if (buf[5] & 0x10) /* footer */
+		size += 10;
+
+	return size;
+}
+
+static gboolean
+is_mpeg_frame_header (const guchar *p)
+{
+	if (p[0] != 0xff || (p[1] & 0xe0) != 0xe0)
+		return FALSE;
+
+	/* ADTS: twelve sync bits, and layer 0 */
+	if ((p[1] & 0xf6) == 0xf0)
+		return ((p[2] >> 2) & 0x0f) < 13; /* sample rate index */
+
+	return ((p[1] >> 3) & 0x03) != 0x01 && /* reserved version */
+	       ((p[1] >> 1) & 0x03) != 0x00 && /* reserved layer */
+	       (p[2] >> 4) != 0x0f &&          /* bad bitrate */
+	       ((p[2] >> 2) & 0x03) != 0x03;   /* reserved sample rate */
+}
+
+static AudioSniffResult
+check_mpeg (const guchar *buf, gsize len)
+{
+	gsize i;
+
+	/* Encoders may leave some junk before the first frame, so look
+	 * at the whole buffer rather than only at its start.
+	 */
+	for (i = 0; i + 3 <= len; i++) {
+		if (is_mpeg_frame_header (buf + i))
+			return AUDIO_SNIFF_AUDIO;
+	}
+
+	/* RIFF-wrapped MPEG, as some rippers write */
+	if (len >= 12 && memcmp (buf, "RIFF", 4) == 0 &&
+	    memcmp (buf + 8, "WAVE", 4) == 0)
+		return AUDIO_SNIFF_AUDIO;
+
+	/* The first frame may start beyond what we read */
+	if (len == SNIFF_SIZE)
+		return AUDIO_SNIFF_UNKNOWN;
+
+	return AUDIO_SNIFF_NOT_AUDIO;
+}
+
+static AudioSniffResult
+check_ogg (const guchar *buf, gsize len)
+{
+	if (len < 4 || memcmp (buf, "OggS", 4) != 0)
+		return AUDIO_SNIFF_NOT_AUDIO;
+
+	/* The first packet of the first page names the codec. A video
+	 * stream always comes first in the file.
+	 */
+	if (len >= 28 + 7 && memcmp (buf + 28, "\x80theora", 7) == 0)
+		return AUDIO_SNIFF_NOT_AUDIO;
+
+	return AUDIO_SNIFF_AUDIO;
+}
+
+static AudioSniffResult
+check_mp4 (const guchar *buf, gsize len)
+{
+	static const char *atoms[] = {
+		"ftyp", "moov", "mdat", "free", "skip", "wide", NULL
+	};
+	int i;
+
+	if (len < 8)
+		return AUDIO_SNIFF_NOT_AUDIO;
+
+	/* Whether an MP4 file holds video too is for the tag reader to
+	 * find out; it's in the atoms further down.
+	 */
+	for (i = 0; atoms[i] != NULL; i++) {
+		if (memcmp (buf + 4, atoms[i], 4) == 0)
+			return AUDIO_SNIFF_AUDIO;
+	}
+
+	return AUDIO_SNIFF_NOT_AUDIO;
+}
+
+static AudioSniffResult
+check_magic (const guchar *buf, gsize len, const char *magic)
+{
+	gsize magic_len = strlen (magic);
+
+	if (len < magic_len || memcmp (buf, magic, magic_len) != 0)
+		return AUDIO_SNIFF_NOT_AUDIO;
+
+	return AUDIO_SNIFF_AUDIO;
+}
+
+AudioSniffResult
+audio_sniffer_check (const char *filename)
+{
+	guchar buf[SNIFF_SIZE];
+	Format format;
+	AudioSniffResult result;
+	gsize skip;
+	ssize_t len;
+	int fd;
+
+	g_return_val_if_fail (filename != NULL, AUDIO_SNIFF_UNKNOWN);
+
+	format = format_from_filename (filename);
+	if (format == FORMAT_UNKNOWN)
+		return AUDIO_SNIFF_UNKNOWN;
+
+	fd = open (filename, O_RDONLY);
+	if (fd < 0)
+		return AUDIO_SNIFF_UNKNOWN;
+
+	len = pread (fd, buf, SNIFF_SIZE, 0);
+
+	/* An ID3v2 tag may come before the actual data of MP3s, and
+	 * sometimes of other formats too.
+	 */
+	skip = (len > 0) ? id3v2_size (buf, len) : 0;
+	if (skip > 0) {
+		if (format == FORMAT_MPEG) {
+			/* That's reason enough to believe it */
+			close (fd);
+			return AUDIO_SNIFF_AUDIO;
+		}
+
+		len = pread (fd, buf, SNIFF_SIZE, skip);
+	}
+
+	close (fd);
+
+	if (len < 0)
+		return AUDIO_SNIFF_UNKNOWN;
+
+	switch (format) {
+	case FORMAT_MPEG:
+		result = check_mpeg (buf, len);
+		break;
+	case FORMAT_FLAC:
+		result = check_magic (buf, len, "fLaC");
+		break;
+	case FORMAT_OGG:
+		result = check_ogg (buf, len);
+		break;
+	case FORMAT_MP4:
+		result = check_mp4 (buf, len);
+		break;
+	case FORMAT_WAVPACK:
+		result = check_magic (buf, len, "wvpk");
+		break;
+	default:
+		result = AUDIO_SNIFF_UNKNOWN;
+		break;
+	}
+
+	return result;
+}
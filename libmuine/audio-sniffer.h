@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __AUDIO_SNIFFER_H
+#define __AUDIO_SNIFFER_H
+
+#include <glib.h>
+
+typedef enum {
+	AUDIO_SNIFF_UNKNOWN,   /* couldn't tell, let the tag reader decide */
+	AUDIO_SNIFF_AUDIO,
+	AUDIO_SNIFF_NOT_AUDIO
+} AudioSniffResult;
+
+AudioSniffResult audio_sniffer_check (const char *filename);
+
+#endif /* __AUDIO_SNIFFER_H */
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Rounded corners and a border for covers. Cairo draws them into an
+ * ARGB32 surface, which is then swizzled into the pixbuf a row at a
+ * time. The swizzle uses SSSE3 or AVX2 byte shuffles where the CPU
+ * has them.
+ *
+ * Also hashes the pixels of finished covers, so identical ones can be
+ * stored once.
+ */
+
+#include <config.h>
+
+#include <gdk/gdk.h>
+
+#include "cover-render.h"
+
+#define RADIUS 5.0
+
+#if defined (__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)) && \
+    (defined (__x86_64__) || defined (__i386__))
+#define HAVE_X86_SIMD 1
+
+#include <immintrin.h>
+#endif
+
+typedef void (*SwizzleFunc) (const guint8 *src, guint8 *dst, int n_pixels);
+
+/* Cairo's ARGB32 pixels are native endian words, pixbufs are R, G, B, A
+ * bytes. Neither is unpremultiplied, the cover is opaque except for the
+ * antialiased edge.
+ */
+static void
+swizzle_scalar (const guint8 *src, guint8 *dst, int n_pixels)
+{
+	const guint32 *s = (const guint32 *) src;
+	int i;
+
+	for (i = 0; i < n_pixels; i++) {
+		guint32 p = s[i];
+
+		dst[0] = (p >> 16) & 0xff;
+		dst[1] = (p >> 8) & 0xff;
+		dst[2] = p & 0xff;
+		dst[3] = p >> 24;
+
+		dst += 4;
+	}
+}
+
+#ifdef HAVE_X86_SIMD
+/* x86 is little endian, so each pixel is B, G, R, A in memory */
+__attribute__ ((target ("ssse3")))
+static void
+swizzle_ssse3 (const guint8 *src, guint8 *dst, int n_pixels)
+{
+	const __m128i mask = _mm_setr_epi8 (2, 1, 0, 3, 6, 5, 4, 7,
+					    10, 9, 8, 11, 14, 13, 12, 15);
+	int i;
+
+	for (i = 0; i + 4 <= n_pixels; i += 4) {
+		__m128i p = _mm_loadu_si128 ((const __m128i *) (src + i * 4));
+
+		_mm_storeu_si128 ((__m128i *) (dst + i * 4),
+				  _mm_shuffle_epi8 (p, mask));
+	}
+
+	swizzle_scalar (src + i * 4, dst + i * 4, n_pixels - i);
+}
+
+__attribute__ ((target ("avx2")))
+static void
+swizzle_avx2 (const guint8 *src, guint8 *dst, int n_pixels)
+{
+	/* vpshufb shuffles within each 128 bit lane */
+	const __m256i mask = _mm256_setr_epi8 (2, 1, 0, 3, 6, 5, 4, 7,
+					       10, 9, 8, 11, 14, 13, 12, 15,
+					       2, 1, 0, 3, 6, 5, 4, 7,
+					       10, 9, 8, 11, 14, 13, 12, 15);
+	int i;
+
+	for (i = 0; i + 8 <= n_pixels; i += 8) {
+		__m256i p = _mm256_loadu_si256 ((const __m256i *) (src + i * 4));
+
+		_mm256_storeu_si256 ((__m256i *) (dst + i * 4),
+				     _mm256_shuffle_epi8 (p, mask));
+	}
+
+	swizzle_scalar (src + i * 4, dst + i * 4, n_pixels - i);
+}
+#endif
+
+static SwizzleFunc
+get_swizzle_func (void)
+{
+	static gsize func = 0;
+
+	if (g_once_init_enter (&func)) {
+		SwizzleFunc f = swizzle_scalar;
+
+#ifdef HAVE_X86_SIMD
+		__builtin_cpu_init ();
+
+		if (__builtin_cpu_supports ("avx2"))
+			f = swizzle_avx2;
+		else if (__builtin_cpu_supports ("ssse3"))
+			f = swizzle_ssse3;
+#endif
+
+		g_once_init_leave (&func, (gsize) f);
+	}
+
+	return (SwizzleFunc) func;
+}
+
+/* Returns a new pixbuf with the corners of input rounded off, and a
+ * translucent 1px border inside its edge.
+ */
+GdkPixbuf *
+cover_round_off (GdkPixbuf *input)
+{
+	cairo_surface_t *surface;
+	cairo_t *cr;
+	GdkPixbuf *output;
+	SwizzleFunc swizzle;
+	const guint8 *src;
+	guint8 *dst;
+	int width, height, src_stride, dst_stride, row;
+	double x, y, w, h;
+
+	width = gdk_pixbuf_get_width (input);
+	height = gdk_pixbuf_get_height (input);
+
+	surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+					      width, height);
+	cr = cairo_create (surface);
+
+	x = 1;
+	y = 1;
+	w = width - 2;
+	h = height - 2;
+
+	cairo_move_to (cr, x + RADIUS, y);
+	cairo_arc (cr, x + w - RADIUS, y + RADIUS, RADIUS, G_PI * 1.5, G_PI * 2);
+	cairo_arc (cr, x + w - RADIUS, y + h - RADIUS, RADIUS, 0, G_PI * .5);
+	cairo_arc (cr, x + RADIUS, y + h - RADIUS, RADIUS, G_PI * .5, G_PI);
+	cairo_arc (cr, x + RADIUS, y + RADIUS, RADIUS, G_PI, G_PI * 1.5);
+
+	gdk_cairo_set_source_pixbuf (cr, input, 0, 0);
+	cairo_fill_preserve (cr);
+
+	cairo_set_line_width (cr, 1);
+	cairo_set_source_rgba (cr, 0, 0, 0, 0.5);
+	cairo_stroke (cr);
+
+	cairo_destroy (cr);
+	cairo_surface_flush (surface);
+
+	output = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, width, height);
+
+	src = cairo_image_surface_get_data (surface);
+	src_stride = cairo_image_surface_get_stride (surface);
+
+	dst = gdk_pixbuf_get_pixels (output);
+	dst_stride = gdk_pixbuf_get_rowstride (output);
+
+	swizzle = get_swizzle_func ();
+
+	for (row = 0; row < height; row++)
+		swizzle (src + row * src_stride, dst + row * dst_stride, width);
+
+	cairo_surface_destroy (surface);
+
+	return output;
+}
+
+/* Returns a 64-bit FNV-1a hash of the size and pixels of pixbuf, which
+ * tells covers with identical pixels apart from the rest. The padding
+ * at the end of each row is left out, as it's not initialized.
+ */
+guint64
+cover_hash (GdkPixbuf *pixbuf)
+{
+	const guint8 *pixels;
+	guint64 hash = G_GUINT64_CONSTANT (0xcbf29ce484222325);
+	int width, height, n_channels, stride, row_len, row, i;
+	int header[3];
+	const guint8 *p;
+
+	width = gdk_pixbuf_get_width (pixbuf);
+	height = gdk_pixbuf_get_height (pixbuf);
+	n_channels = gdk_pixbuf_get_n_channels (pixbuf);
+	stride = gdk_pixbuf_get_rowstride (pixbuf);
+	pixels = gdk_pixbuf_get_pixels (pixbuf);
+
+	header[0] = width;
+	header[1] = height;
+	header[2] = n_channels;
+
+	p = (const guint8 *) header;
+	for (i = 0; i < (int) sizeof (header); i++) {
+		hash ^= p[i];
+		hash *= G_GUINT64_CONSTANT (0x100000001b3);
+	}
+
+	row_len = width * n_channels;
+
+	for (row = 0; row < height; row++) {
+		p = pixels + row * stride;
+
+		for (i = 0; i < row_len; i++) {
+			hash ^= p[i];
+			hash *= G_GUINT64_CONSTANT (0x100000001b3);
+		}
+	}
+
+	return hash;
+}
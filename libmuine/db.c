@@ -17,6 +17,10 @@
  * Boston, MA 02110-1301, USA.
  *
  * Some code stolen from song-db.c from Jamboree.
+ *
+ * Pixbufs are packed as PNG, or as RLE compressed GdkPixdata where PNG
+ * can't be written. Older databases hold plain GdkPixdata; both kinds
+ * start with a magic number, so they're told apart when unpacking.
  */
 
 #include <gdk-pixbuf/gdk-pixdata.h>
@@ -34,6 +38,8 @@
 
 #define VERSION_KEY "version"
 
+static const guint8 png_magic[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
 gpointer
 db_open (const char *filename,
 	 int version,
@@ -158,6 +164,29 @@ db_store (gpointer db,
 	g_free (datum.dptr);
 }
 
+gboolean
+db_fetch (gpointer db,
+	  const char *key_str,
+	  ForeachDecodeFunc func,
+	  gpointer user_data)
+{
+	datum key, data;
+
+	memset (&key, 0, sizeof (key));
+	key.dptr = (gpointer) key_str;
+	key.dsize = strlen (key_str);
+
+	data = gdbm_fetch ((GDBM_FILE) db, key);
+	if (data.dptr == NULL)
+		return FALSE;
+
+	func (key_str, (gpointer) data.dptr, user_data);
+
+	free (data.dptr);
+
+	return TRUE;
+}
+
 void
 db_foreach (gpointer db,
 	    ForeachDecodeFunc func,
@@ -246,11 +275,90 @@ db_unpack_double (gpointer p, double *val)
 	return ret;
 }
 
+static gboolean
+is_png (const guint8 *data, int len)
+{
+	return len >= (int) sizeof (png_magic) &&
+	       memcmp (data, png_magic, sizeof (png_magic)) == 0;
+}
+
+static GdkPixbuf *
+pixbuf_from_png (const guint8 *data, int len)
+{
+	GdkPixbufLoader *loader;
+	GdkPixbuf *pixbuf = NULL;
+	gboolean written, closed;
+
+	loader = gdk_pixbuf_loader_new_with_type ("png", NULL);
+	if (loader == NULL)
+		return NULL;
+
+	/* Close exactly once, also when writing failed */
+	written = gdk_pixbuf_loader_write (loader, data, len, NULL);
+	closed = gdk_pixbuf_loader_close (loader, NULL);
+
+	if (written && closed) {
+		pixbuf = gdk_pixbuf_loader_get_pixbuf (loader);
+		if (pixbuf)
+			g_object_ref (pixbuf);
+	}
+
+	g_object_unref (loader);
+
+	return pixbuf;
+}
+
 gpointer
 db_unpack_pixbuf (gpointer p, GdkPixbuf **pixbuf)
+{
+	gpointer data;
+	int len;
+
+	p = db_unpack_pixbuf_data (p, &data, &len);
+
+	if (pixbuf)
+		*pixbuf = db_pixbuf_from_data (data, len);
+
+	return p;
+}
+
+/* Finds the packed pixbuf at p without decoding it, so it can be
+ * copied out of the record and decoded later */
+gpointer
+db_unpack_pixbuf_data (gpointer p, gpointer *data, int *len)
+{
+	p = _ALIGN_ADDRESS (p, 4);
+
+	*len = *(int *) p;
+
+	p = (gpointer) ((unsigned long) p + 4);
+
+	*data = p;
+
+	return (gpointer) ((unsigned long) p + *len + 1);
+}
+
+GdkPixbuf *
+db_pixbuf_from_data (gconstpointer data, int len)
+{
+	GdkPixdata pixdata;
+
+	if (is_png (data, len))
+		return pixbuf_from_png (data, len);
+
+	if (!gdk_pixdata_deserialize (&pixdata, len, data, NULL))
+		return NULL;
+
+	/* The data may go away with the record */
+	return gdk_pixbuf_from_pixdata (&pixdata, TRUE, NULL);
+}
+
+/* Whether the pixbuf at p was packed the old way, as plain GdkPixdata */
+gboolean
+db_pixbuf_needs_repack (gpointer p)
 {
 	int len;
-	GdkPixdata *pixdata;
+	GdkPixdata pixdata;
 
 	p = _ALIGN_ADDRESS (p, 4);
 
@@ -258,15 +366,14 @@ db_unpack_pixbuf (gpointer p, GdkPixbuf **pixbuf)
 
 	p = (gpointer) ((unsigned long) p + 4);
 
-	pixdata = g_new0 (GdkPixdata, 1);
-	gdk_pixdata_deserialize (pixdata, len, (const guint8 *) p, NULL);
-
-	if (pixbuf)
-		*pixbuf = gdk_pixbuf_from_pixdata (pixdata, TRUE, NULL);
+	if (is_png (p, len))
+		return FALSE;
 
-	g_free (pixdata);
+	if (!gdk_pixdata_deserialize (&pixdata, len, p, NULL))
+		return FALSE;
 
-	return (gpointer) ((unsigned long) p + len + 1);
+	return (pixdata.pixdata_type & GDK_PIXDATA_ENCODING_MASK) !=
+	       GDK_PIXDATA_ENCODING_RLE;
 }
 
 static void
@@ -339,29 +446,39 @@ void
 db_pack_pixbuf (gpointer p, GdkPixbuf *pixbuf)
 {
 	GString *string = (GString *) p;
-	GdkPixdata *pixdata;
-	guint len = 0;
-	char *str;
-
-	pixdata = g_new0 (GdkPixdata, 1);
-	gdk_pixdata_from_pixbuf (pixdata, pixbuf, FALSE);
-
-	str = (char *) gdk_pixdata_serialize (pixdata, &len);
+	gchar *buf = NULL;
+	gsize len = 0;
+
+	if (!gdk_pixbuf_save_to_buffer (pixbuf, &buf, &len, "png", NULL,
+					"compression", "9", NULL)) {
+		GdkPixdata pixdata;
+		gpointer rle;
+		guint rle_len = 0;
+
+		/* Keep the RLE data alive until it's serialized */
+		rle = gdk_pixdata_from_pixbuf (&pixdata, pixbuf, TRUE);
+		buf = (gchar *) gdk_pixdata_serialize (&pixdata, &rle_len);
+		len = rle_len;
+		g_free (rle);
+	}
 
 	db_pack_int (string, len);
 
-	if (str) {
-		int i;
-		for (i = 0; i < len; i++)
-			g_string_append_c (string, str [i]);
-		g_free (str);
+	if (buf) {
+		g_string_append_len (string, buf, len);
+		g_free (buf);
 	}
 
-	g_free (pixdata);
-
 	g_string_append_c (string, 0);
 }
 
+/* Gives the space of deleted and replaced records back to the system */
+void
+db_reorganize (gpointer db)
+{
+	gdbm_reorganize ((GDBM_FILE) db);
+}
+
 gpointer
 db_pack_end (gpointer p, int *len)
 {
@@ -42,15 +42,23 @@ void     db_store         (gpointer db,
 	                   gboolean overwrite,
 	                   gpointer data,
 	                   int data_size);
+gboolean db_fetch         (gpointer db,
+	                   const char *key_str,
+	                   ForeachDecodeFunc func,
+	                   gpointer user_data);
 void     db_foreach       (gpointer db,
 	                   ForeachDecodeFunc func,
 	                   gpointer user_data);
+void     db_reorganize    (gpointer db);
 
 gpointer db_unpack_string (gpointer p, char **str);
 gpointer db_unpack_int    (gpointer p, int *val);
 gpointer db_unpack_bool   (gpointer p, gboolean *val);
 gpointer db_unpack_double (gpointer p, double *val);
 gpointer db_unpack_pixbuf (gpointer p, GdkPixbuf **pixbuf);
+gpointer db_unpack_pixbuf_data (gpointer p, gpointer *data, int *len);
+GdkPixbuf *db_pixbuf_from_data (gconstpointer data, int len);
+gboolean db_pixbuf_needs_repack (gpointer p);
 
 gpointer db_pack_start    (void);
 void     db_pack_string   (gpointer p, const char *str);
@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Walks a directory tree without recursion and without stat'ing every
+ * entry: on Linux the entries are read with getdents64, and d_type tells
+ * files from directories. Only when the file system doesn't fill in
+ * d_type, or for symlinks, we fall back to fstatat. Files that don't
+ * look like music are dropped here, before managed code sees them.
+ *
+ * dir_walker_list does the same for a single directory, for callers
+ * which decide themselves which directories to descend into.
+ */
+
+#include <config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include <glib.h>
+
+#include "dir-walker.h"
+#include "macros.h"
+
+#define DIR_BUFFER_SIZE 32768
+
+typedef enum {
+	ENTRY_UNKNOWN,
+	ENTRY_FILE,
+	ENTRY_DIR,
+	ENTRY_OTHER
+} EntryType;
+
+struct _DirWalker {
+	GQueue     *pending; /* directories still to read, depth first */
+	GQueue     *found;   /* files found but not handed out yet */
+	GHashTable *visited; /* directories read so far, against symlink loops */
+};
+
+#ifdef __linux__
+struct linux_dirent64 {
+	guint64        d_ino;
+	gint64         d_off;
+	unsigned short d_reclen;
+	unsigned char  d_type;
+	char           d_name[];
+};
+#endif
+
+static const char *audio_extensions[] = {
+	"mp3", "mp2", "ogg", "oga", "spx", "opus", "flac", "m4a", "m4b",
+	"m4p", "mp4", "aac", "wma", "asf", "wav", "wv", "mpc", "mp+",
+	"mpp", "ape", "aif", "aiff", "aifc", "tta", "mka",
+	NULL
+};
+
+gboolean
+dir_walker_is_audio_file (const char *filename)
+{
+	const char *ext;
+	int i;
+
+	ext = strrchr (filename, '.');
+	if (ext == NULL)
+		return FALSE;
+
+	ext++;
+
+	for (i = 0; audio_extensions[i] != NULL; i++) {
+		if (g_ascii_strcasecmp (ext, audio_extensions[i]) == 0)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static gboolean
+is_dot_or_dot_dot (const char *name)
+{
+	return name[0] == '.' &&
+	       (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+static EntryType
+entry_type_from_stat (int dir_fd, const char *name)
+{
+	struct stat st;
+
+	/* Follows symlinks, like DirectoryInfo did */
+	if (fstatat (dir_fd, name, &st, 0) < 0)
+		return ENTRY_OTHER;
+
+	if (S_ISDIR (st.st_mode))
+		return ENTRY_DIR;
+
+	if (S_ISREG (st.st_mode))
+		return ENTRY_FILE;
+
+	return ENTRY_OTHER;
+}
+
+#ifdef _DIRENT_HAVE_D_TYPE
+static EntryType
+entry_type_from_d_type (unsigned char d_type)
+{
+	switch (d_type) {
+	case DT_REG:
+		return ENTRY_FILE;
+	case DT_DIR:
+		return ENTRY_DIR;
+	case DT_UNKNOWN:
+	case DT_LNK:
+		return ENTRY_UNKNOWN;
+	default:
+		return ENTRY_OTHER;
+	}
+}
+#endif
+
+typedef void (*EntryFunc) (int dir_fd, const char *name, EntryType type,
+			   gpointer user_data);
+
+/* Calls func for every entry of the open directory fd, except . and ..,
+ * and closes fd.
+ */
+static void
+read_entries (int fd, EntryFunc func, gpointer user_data)
+{
+#ifdef __linux__
+	char *buffer;
+
+	buffer = g_malloc (DIR_BUFFER_SIZE);
+
+	for (;;) {
+		long n, offset;
+
+		n = syscall (SYS_getdents64, fd, buffer, DIR_BUFFER_SIZE);
+		if (n <= 0)
+			break;
+
+		for (offset = 0; offset < n; ) {
+			struct linux_dirent64 *d;
+
+			d = (struct linux_dirent64 *) (buffer + offset);
+			offset += d->d_reclen;
+
+			if (is_dot_or_dot_dot (d->d_name))
+				continue;
+
+			func (fd, d->d_name, entry_type_from_d_type (d->d_type),
+			      user_data);
+		}
+	}
+
+	g_free (buffer);
+	close (fd);
+#else
+	DIR *dir;
+	struct dirent *d;
+
+	dir = fdopendir (fd);
+	if (dir == NULL) {
+		close (fd);
+		return;
+	}
+
+	while ((d = readdir (dir)) != NULL) {
+#ifdef _DIRENT_HAVE_D_TYPE
+		EntryType type = entry_type_from_d_type (d->d_type);
+#else
+		EntryType type = ENTRY_UNKNOWN;
+#endif
+		if (is_dot_or_dot_dot (d->d_name))
+			continue;
+
+		func (dirfd (dir), d->d_name, type, user_data);
+	}
+
+	closedir (dir);
+#endif
+}
+
+typedef struct {
+	DirWalker  *walker;
+	const char *path;
+} WalkData;
+
+static void
+walk_entry (int dir_fd, const char *name, EntryType type, gpointer user_data)
+{
+	WalkData *data = user_data;
+
+	if (type == ENTRY_UNKNOWN)
+		type = entry_type_from_stat (dir_fd, name);
+
+	if (type == ENTRY_DIR) {
+		g_queue_push_head (data->walker->pending,
+				   g_build_filename (data->path, name, NULL));
+
+	} else if (type == ENTRY_FILE && dir_walker_is_audio_file (name)) {
+		g_queue_push_tail (data->walker->found,
+				   g_build_filename (data->path, name, NULL));
+	}
+}
+
+static gboolean
+mark_visited (DirWalker *walker, int fd)
+{
+	struct stat st;
+	char *key;
+
+	if (fstat (fd, &st) < 0)
+		return FALSE;
+
+	key = g_strdup_printf ("%lu:%lu", (unsigned long) st.st_dev,
+			       (unsigned long) st.st_ino);
+
+	if (g_hash_table_lookup (walker->visited, key)) {
+		g_free (key);
+		return FALSE;
+	}
+
+	g_hash_table_insert (walker->visited, key, GINT_TO_POINTER (TRUE));
+
+	return TRUE;
+}
+
+static void
+read_dir (DirWalker *walker, char *path)
+{
+	WalkData data;
+	int fd;
+
+	fd = open (path, O_RDONLY | O_DIRECTORY);
+	if (fd < 0)
+		goto out;
+
+	if (!mark_visited (walker, fd)) {
+		close (fd);
+		goto out;
+	}
+
+	data.walker = walker;
+	data.path = path;
+
+	read_entries (fd, walk_entry, &data);
+
+ out:
+	g_free (path);
+}
+
+DirWalker *
+dir_walker_new (const char *root)
+{
+	DirWalker *walker;
+
+	walker = g_new0 (DirWalker, 1);
+
+	walker->pending = g_queue_new ();
+	walker->found = g_queue_new ();
+	walker->visited = g_hash_table_new_full (g_str_hash, g_str_equal,
+						 g_free, NULL);
+
+	g_queue_push_head (walker->pending, g_strdup (root));
+
+	return walker;
+}
+
+/* Returns up to max_paths music files, as one buffer of NUL-terminated
+ * paths, and its total size in length. Returns NULL once the walk is
+ * done. Free the buffer with g_free.
+ */
+char *
+dir_walker_next_batch (DirWalker *walker, int max_paths, int *length)
+{
+	GString *batch;
+	char *path;
+	int n = 0;
+
+	while (g_queue_get_length (walker->found) < (guint) max_paths &&
+	       !g_queue_is_empty (walker->pending))
+		read_dir (walker, g_queue_pop_head (walker->pending));
+
+	if (g_queue_is_empty (walker->found)) {
+		*length = 0;
+		return NULL;
+	}
+
+	batch = g_string_new (NULL);
+
+	while (n < max_paths &&
+	       (path = g_queue_pop_head (walker->found)) != NULL) {
+		g_string_append_len (batch, path, strlen (path) + 1);
+		g_free (path);
+		n++;
+	}
+
+	*length = batch->len;
+
+	return g_string_free (batch, FALSE);
+}
+
+static void
+free_path (gpointer path, gpointer UNUSED(user_data))
+{
+	g_free (path);
+}
+
+void
+dir_walker_free (DirWalker *walker)
+{
+	g_queue_foreach (walker->pending, free_path, NULL);
+	g_queue_free (walker->pending);
+
+	g_queue_foreach (walker->found, free_path, NULL);
+	g_queue_free (walker->found);
+
+	g_hash_table_destroy (walker->visited);
+	g_free (walker);
+}
+
+static void
+list_entry (int dir_fd, const char *name, EntryType type, gpointer user_data)
+{
+	GString *list = user_data;
+
+	if (type == ENTRY_UNKNOWN)
+		type = entry_type_from_stat (dir_fd, name);
+
+	if (type == ENTRY_DIR)
+		g_string_append_c (list, 'd');
+	else if (type == ENTRY_FILE && dir_walker_is_audio_file (name))
+		g_string_append_c (list, 'f');
+	else
+		return;
+
+	g_string_append_len (list, name, strlen (name) + 1);
+}
+
+/* Lists a single directory, without descending into it. Every entry
+ * is NUL-terminated, and prefixed with 'd' for a directory or 'f' for a
+ * music file; other entries are left out. Returns NULL if the directory
+ * can't be read. Free the buffer with g_free.
+ */
+char *
+dir_walker_list (const char *path, int *length)
+{
+	GString *list;
+	int fd;
+
+	fd = open (path, O_RDONLY | O_DIRECTORY);
+	if (fd < 0) {
+		*length = 0;
+		return NULL;
+	}
+
+	list = g_string_new (NULL);
+
+	read_entries (fd, list_entry, list);
+
+	*length = list->len;
+
+	return g_string_free (list, FALSE);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DIR_WALKER_H
+#define __DIR_WALKER_H
+
+#include <glib.h>
+
+typedef struct _DirWalker DirWalker;
+
+DirWalker *dir_walker_new           (const char *root);
+char      *dir_walker_next_batch    (DirWalker *walker,
+				     int max_paths,
+				     int *length);
+void       dir_walker_free          (DirWalker *walker);
+
+char      *dir_walker_list          (const char *path,
+				     int *length);
+
+gboolean   dir_walker_is_audio_file (const char *filename);
+
+#endif /* __DIR_WALKER_H */
@@ -0,0 +1,434 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Batched stat and header reads. On slow storage, a library scan is
+ * bound by round trips rather than bandwidth, so we keep many requests
+ * in flight at once: through io_uring when we were built with liburing
+ * and the kernel lets us use it, and on a few threads otherwise.
+ *
+ * io_batch_prefetch reads the first and last HEADER_SIZE bytes of every
+ * file, which is where ID3v2, ID3v1, APE and FLAC keep their tags, and
+ * throws them away; the tag reader then finds them in the page cache.
+ *
+ * Both run at the I/O priority of the calling thread: the threads we
+ * start inherit it, and io_uring reads are tagged with it.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* statx */
+#endif
+
+#include <config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_LIBURING
+#include <sys/sysmacros.h>
+#include <liburing.h>
+#endif
+
+#include <glib.h>
+
+#include "io-batch.h"
+#include "io-priority.h"
+
+#define HEADER_SIZE (64 * 1024)
+#define N_THREADS   8
+
+#ifdef HAVE_LIBURING
+#define QUEUE_DEPTH 64
+#endif
+
+static void
+stat_one (const char *path, IoStat *result)
+{
+	struct stat st;
+
+	memset (result, 0, sizeof (IoStat));
+
+	if (stat (path, &st) < 0) {
+		result->error = errno;
+		return;
+	}
+
+	result->mtime = st.st_mtime;
+	result->size = st.st_size;
+	result->dev = st.st_dev;
+	result->ino = st.st_ino;
+}
+
+static void
+prefetch_one (const char *path, char *buffer)
+{
+	struct stat st;
+	int fd;
+
+	fd = open (path, O_RDONLY);
+	if (fd < 0)
+		return;
+
+	if (fstat (fd, &st) == 0) {
+		ssize_t n = pread (fd, buffer, HEADER_SIZE, 0);
+
+		if (n == HEADER_SIZE && st.st_size > HEADER_SIZE)
+			n = pread (fd, buffer, HEADER_SIZE, st.st_size - HEADER_SIZE);
+	}
+
+	close (fd);
+}
+
+/* Thread pool fallback */
+
+typedef struct {
+	const char    **paths;
+	int             n_paths;
+	int             next;
+	pthread_mutex_t lock;
+	IoStat         *results; /* NULL when prefetching */
+} Jobs;
+
+static void *
+job_thread (void *data)
+{
+	Jobs *jobs = data;
+	char *buffer = NULL;
+
+	if (jobs->results == NULL)
+		buffer = g_malloc (HEADER_SIZE);
+
+	for (;;) {
+		int i;
+
+		pthread_mutex_lock (&jobs->lock);
+		i = jobs->next++;
+		pthread_mutex_unlock (&jobs->lock);
+
+		if (i >= jobs->n_paths)
+			break;
+
+		if (jobs->results != NULL)
+			stat_one (jobs->paths[i], &jobs->results[i]);
+		else
+			prefetch_one (jobs->paths[i], buffer);
+	}
+
+	g_free (buffer);
+
+	return NULL;
+}
+
+static void
+run_jobs (const char **paths, int n_paths, IoStat *results)
+{
+	pthread_t threads[N_THREADS - 1];
+	Jobs jobs;
+	int n_threads, i;
+
+	jobs.paths = paths;
+	jobs.n_paths = n_paths;
+	jobs.next = 0;
+	jobs.results = results;
+	pthread_mutex_init (&jobs.lock, NULL);
+
+	/* We work along ourselves, so we get by even if no thread starts */
+	for (n_threads = 0; n_threads < MIN (N_THREADS, n_paths) - 1; n_threads++) {
+		if (pthread_create (&threads[n_threads], NULL, job_thread, &jobs) != 0)
+			break;
+	}
+
+	job_thread (&jobs);
+
+	for (i = 0; i < n_threads; i++)
+		pthread_join (threads[i], NULL);
+
+	pthread_mutex_destroy (&jobs.lock);
+}
+
+#ifdef HAVE_LIBURING
+
+/* Waits for the next completion. Returns FALSE if the ring broke. */
+static gboolean
+wait_cqe (struct io_uring *ring, struct io_uring_cqe **cqe)
+{
+	int ret;
+
+	do {
+		ret = io_uring_wait_cqe (ring, cqe);
+	} while (ret == -EINTR);
+
+	return ret == 0;
+}
+
+/* Submits what's queued. Returns the number of requests submitted, or
+ * -1 if the ring broke.
+ */
+static int
+submit (struct io_uring *ring)
+{
+	int ret;
+
+	do {
+		ret = io_uring_submit (ring);
+	} while (ret == -EINTR);
+
+	return ret < 0 ? -1 : ret;
+}
+
+static gboolean
+uring_stat (const char **paths, int n_paths, IoStat *results)
+{
+	struct io_uring ring;
+	struct statx *bufs;
+	gboolean *done;
+	int queued = 0, in_flight = 0, i;
+	gboolean broken = FALSE;
+
+	if (io_uring_queue_init (QUEUE_DEPTH, &ring, 0) < 0)
+		return FALSE;
+
+	bufs = g_new (struct statx, n_paths);
+	done = g_new0 (gboolean, n_paths);
+
+	while (!broken && (queued < n_paths || in_flight > 0)) {
+		struct io_uring_cqe *cqe;
+		int n;
+
+		/* Keep the ring full */
+		while (queued < n_paths && in_flight < QUEUE_DEPTH) {
+			struct io_uring_sqe *sqe = io_uring_get_sqe (&ring);
+			if (sqe == NULL)
+				break;
+
+			io_uring_prep_statx (sqe, AT_FDCWD, paths[queued], 0,
+					     STATX_BASIC_STATS, &bufs[queued]);
+			io_uring_sqe_set_data (sqe, GINT_TO_POINTER (queued));
+
+			queued++;
+			in_flight++;
+		}
+
+		n = submit (&ring);
+		if (n < 0) {
+			broken = TRUE;
+			break;
+		}
+
+		if (!wait_cqe (&ring, &cqe)) {
+			broken = TRUE;
+			break;
+		}
+
+		do {
+			IoStat *result;
+
+			i = GPOINTER_TO_INT (io_uring_cqe_get_data (cqe));
+			result = &results[i];
+
+			if (cqe->res == -EINVAL || cqe->res == -EOPNOTSUPP) {
+				/* Kernel without IORING_OP_STATX */
+				stat_one (paths[i], result);
+
+			} else if (cqe->res < 0) {
+				memset (result, 0, sizeof (IoStat));
+				result->error = -cqe->res;
+
+			} else {
+				struct statx *stx = &bufs[i];
+
+				result->error = 0;
+				result->mtime = stx->stx_mtime.tv_sec;
+				result->size = stx->stx_size;
+				result->dev = makedev (stx->stx_dev_major,
+						       stx->stx_dev_minor);
+				result->ino = stx->stx_ino;
+			}
+
+			done[i] = TRUE;
+			in_flight--;
+
+			io_uring_cqe_seen (&ring, cqe);
+		} while (io_uring_peek_cqe (&ring, &cqe) == 0);
+	}
+
+	io_uring_queue_exit (&ring);
+
+	/* Whatever didn't complete is stat'ed the slow way */
+	if (broken) {
+		for (i = 0; i < n_paths; i++) {
+			if (!done[i])
+				stat_one (paths[i], &results[i]);
+		}
+	}
+
+	/* Requests still in flight when the ring broke may write to
+	 * bufs while they're being canceled, so rather leak it.
+	 */
+	if (in_flight == 0)
+		g_free (bufs);
+
+	g_free (done);
+
+	return TRUE;
+}
+
+typedef struct {
+	int    fd;
+	int    pending;
+	char  *buffer; /* 2 * HEADER_SIZE, head and tail */
+} Slot;
+
+static gboolean
+uring_prefetch (const char **paths, int n_paths)
+{
+	struct io_uring ring;
+	Slot slots[QUEUE_DEPTH / 2];
+	int n_slots = QUEUE_DEPTH / 2;
+	int next = 0, in_flight = 0, i;
+	int ioprio;
+
+	if (io_uring_queue_init (QUEUE_DEPTH, &ring, 0) < 0)
+		return FALSE;
+
+	ioprio = io_priority_get ();
+
+	for (i = 0; i < n_slots; i++) {
+		slots[i].fd = -1;
+		slots[i].pending = 0;
+		slots[i].buffer = g_malloc (2 * HEADER_SIZE);
+	}
+
+	while (next < n_paths || in_flight > 0) {
+		struct io_uring_cqe *cqe;
+
+		/* Start reading headers into every free slot */
+		for (i = 0; i < n_slots && next < n_paths; i++) {
+			Slot *slot = &slots[i];
+			struct io_uring_sqe *sqe;
+			struct stat st;
+
+			if (slot->pending > 0)
+				continue;
+
+			slot->fd = open (paths[next++], O_RDONLY);
+			if (slot->fd < 0)
+				continue;
+
+			if (fstat (slot->fd, &st) < 0) {
+				close (slot->fd);
+				continue;
+			}
+
+			sqe = io_uring_get_sqe (&ring);
+			io_uring_prep_read (sqe, slot->fd, slot->buffer,
+					    HEADER_SIZE, 0);
+			io_uring_sqe_set_data (sqe, slot);
+			sqe->ioprio = ioprio;
+			slot->pending++;
+
+			if (st.st_size > HEADER_SIZE) {
+				sqe = io_uring_get_sqe (&ring);
+				io_uring_prep_read (sqe, slot->fd,
+						    slot->buffer + HEADER_SIZE,
+						    HEADER_SIZE,
+						    st.st_size - HEADER_SIZE);
+				io_uring_sqe_set_data (sqe, slot);
+				sqe->ioprio = ioprio;
+				slot->pending++;
+			}
+
+			in_flight += slot->pending;
+		}
+
+		if (in_flight == 0)
+			continue;
+
+		if (submit (&ring) < 0 || !wait_cqe (&ring, &cqe))
+			break;
+
+		do {
+			Slot *slot = io_uring_cqe_get_data (cqe);
+
+			in_flight--;
+			slot->pending--;
+
+			if (slot->pending == 0) {
+				close (slot->fd);
+				slot->fd = -1;
+			}
+
+			io_uring_cqe_seen (&ring, cqe);
+		} while (io_uring_peek_cqe (&ring, &cqe) == 0);
+	}
+
+	/* If the ring broke, what's in flight is canceled; this is only
+	 * a hint anyway, so we don't retry.
+	 */
+	io_uring_queue_exit (&ring);
+
+	for (i = 0; i < n_slots; i++) {
+		/* May still be written to while being canceled */
+		if (slots[i].pending > 0) {
+			close (slots[i].fd);
+			continue;
+		}
+
+		g_free (slots[i].buffer);
+	}
+
+	return TRUE;
+}
+
+#endif /* HAVE_LIBURING */
+
+void
+io_batch_stat (const char **paths, int n_paths, IoStat *results)
+{
+	g_return_if_fail (paths != NULL || n_paths == 0);
+
+	if (n_paths <= 0)
+		return;
+
+#ifdef HAVE_LIBURING
+	if (uring_stat (paths, n_paths, results))
+		return;
+#endif
+
+	run_jobs (paths, n_paths, results);
+}
+
+void
+io_batch_prefetch (const char **paths, int n_paths)
+{
+	g_return_if_fail (paths != NULL || n_paths == 0);
+
+	if (n_paths <= 0)
+		return;
+
+#ifdef HAVE_LIBURING
+	if (uring_prefetch (paths, n_paths))
+		return;
+#endif
+
+	run_jobs (paths, n_paths, NULL);
+}
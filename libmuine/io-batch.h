@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __IO_BATCH_H
+#define __IO_BATCH_H
+
+#include <glib.h>
+
+typedef struct {
+	int     error;  /* errno, or 0 */
+	int     mtime;
+	gint64  size;
+	guint64 dev;
+	guint64 ino;
+} IoStat;
+
+void io_batch_stat     (const char **paths,
+			int n_paths,
+			IoStat *results);
+
+void io_batch_prefetch (const char **paths,
+			int n_paths);
+
+#endif /* __IO_BATCH_H */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * I/O priorities, as set by ionice. Thread priorities don't touch the
+ * disk queue, so a library scan competes with the file being played on
+ * equal terms unless its threads are put in the idle class, where the
+ * kernel only serves them when nobody else wants the disk.
+ *
+ * The priority is per thread, and inherited by the threads it creates.
+ * glibc has no wrappers, so we use the system calls directly.
+ */
+
+#include <config.h>
+
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include <glib.h>
+
+#include "io-priority.h"
+
+#if defined (__linux__) && defined (SYS_ioprio_set) && defined (SYS_ioprio_get)
+#define HAVE_IOPRIO 1
+
+#define IOPRIO_CLASS_SHIFT 13
+#define IOPRIO_CLASS_IDLE  3
+#define IOPRIO_WHO_PROCESS 1 /* a thread, when given a thread id or 0 */
+#endif
+
+/* Puts the calling thread in the idle I/O class. Returns FALSE where
+ * that isn't supported.
+ */
+gboolean
+io_priority_set_idle (void)
+{
+#ifdef HAVE_IOPRIO
+	int prio = IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT;
+
+	return syscall (SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, prio) == 0;
+#else
+	return FALSE;
+#endif
+}
+
+/* Returns the I/O priority of the calling thread, in the format
+ * io_uring takes for a request, or 0 for the default.
+ */
+int
+io_priority_get (void)
+{
+#ifdef HAVE_IOPRIO
+	int prio = syscall (SYS_ioprio_get, IOPRIO_WHO_PROCESS, 0);
+
+	return prio < 0 ? 0 : prio;
+#else
+	return 0;
+#endif
+}
@@ -37,11 +37,16 @@ static gboolean bus_message_cb (GstBus *bus,
 				GstMessage *message,
 				gpointer data);
 static gboolean tick_timeout  (Player          *player);
+static gboolean starve_timeout (Player         *player);
+
+/* How long we keep saying we're starving after the sink dropped data */
+#define STARVE_HOLD 3000
 
 enum {
 	END_OF_STREAM,
 	TICK,
 	ERROR,
+	STARVING,
 	LAST_SIGNAL
 };
 
@@ -57,6 +62,10 @@ struct _PlayerPriv {
 
 	GTimer     *timer;
 	long        timer_add;
+
+	gboolean    buffering;
+	guint       starve_timeout_id;
+	gboolean    starving;
 };
 
 static GObjectClass *parent_class;
@@ -125,6 +134,15 @@ player_class_init (PlayerClass *klass)
 			      NULL, NULL,
 			      g_cclosure_marshal_VOID__STRING,
 			      G_TYPE_NONE, 1, G_TYPE_STRING);
+
+	signals[STARVING] =
+		g_signal_new ("starving",
+			      G_TYPE_FROM_CLASS (klass),
+			      G_SIGNAL_RUN_LAST,
+			      0,
+			      NULL, NULL,
+			      g_cclosure_marshal_VOID__BOOLEAN,
+			      G_TYPE_NONE, 1, G_TYPE_BOOLEAN);
 }
 
 static void
@@ -182,6 +200,9 @@ player_finalize (GObject *object)
 	if (player->priv->tick_timeout_id > 0)
 		g_source_remove (player->priv->tick_timeout_id);
 
+	if (player->priv->starve_timeout_id > 0)
+		g_source_remove (player->priv->starve_timeout_id);
+
 	gst_element_set_state (GST_ELEMENT (player->priv->play), GST_STATE_NULL);
 	g_object_unref (player->priv->play);
 
@@ -219,6 +240,47 @@ tick_timeout (Player *player)
 	return TRUE;
 }
 
+/* Emits "starving" when the pipeline starts or stops running short of
+ * data: while it's buffering, or for a while after the sink had to drop
+ * or skip samples.
+ */
+static void
+update_starving (Player *player)
+{
+	PlayerPriv *priv = player->priv;
+	gboolean starving;
+
+	starving = priv->buffering || priv->starve_timeout_id > 0;
+	if (starving == priv->starving)
+		return;
+
+	priv->starving = starving;
+
+	g_signal_emit (player, signals[STARVING], 0, starving);
+}
+
+static void
+starved (Player *player)
+{
+	if (player->priv->starve_timeout_id > 0)
+		g_source_remove (player->priv->starve_timeout_id);
+
+	player->priv->starve_timeout_id =
+		g_timeout_add (STARVE_HOLD, (GSourceFunc) starve_timeout, player);
+
+	update_starving (player);
+}
+
+static gboolean
+starve_timeout (Player *player)
+{
+	player->priv->starve_timeout_id = 0;
+
+	update_starving (player);
+
+	return FALSE;
+}
+
 static gboolean
 bus_message_cb (GstBus *UNUSED(bus),
 		GstMessage *message,
@@ -252,6 +314,23 @@ bus_message_cb (GstBus *UNUSED(bus),
 		/* Do nothing */
 		break;
 
+	case GST_MESSAGE_BUFFERING: {
+		gint percent;
+
+		gst_message_parse_buffering (message, &percent);
+
+		player->priv->buffering = (percent < 100);
+		update_starving (player);
+		break;
+	}
+
+#if GST_CHECK_VERSION (0, 10, 29)
+	case GST_MESSAGE_QOS:
+		/* Something in the pipeline dropped data to keep up */
+		starved (player);
+		break;
+#endif
+
 	default:
 		break;
 	}
@@ -313,6 +392,9 @@ player_stop (Player *player)
 	player->priv->timer_add = 0;
 
 	gst_element_set_state (GST_ELEMENT (player->priv->play), GST_STATE_READY);
+
+	player->priv->buffering = FALSE;
+	update_starving (player);
 }
 
 void
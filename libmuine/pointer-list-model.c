@@ -22,6 +22,7 @@
 
 #include <config.h>
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <gtk/gtk.h>
@@ -350,6 +351,7 @@ pointer_list_model_init (PointerListModel *model)
   model->pointers = g_sequence_new (NULL);
   model->reverse_map = g_hash_table_new (NULL, NULL);
   model->stamp = g_random_int ();
+  model->version = 0;
   model->sort_func = NULL;
 
   model->current_pointer = NULL;
@@ -437,6 +439,8 @@ pointer_list_model_add (PointerListModel *model, gpointer pointer)
     new_ptr = g_sequence_append (model->pointers, pointer);
   
   g_hash_table_insert (model->reverse_map, pointer, new_ptr);
+
+  model->version++;
 	
   iter.stamp = model->stamp;
   iter.user_data = new_ptr;
@@ -486,6 +490,8 @@ pointer_list_model_insert (PointerListModel *model, gpointer pointer,
 
   g_hash_table_insert (model->reverse_map, pointer, new_ptr);
 
+  model->version++;
+
   iter.stamp = model->stamp;
   iter.user_data = new_ptr;
 
@@ -512,6 +518,7 @@ pointer_list_model_remove_iter (PointerListModel *model, GtkTreeIter *iter)
   g_sequence_remove (ptr);
   
   model->stamp++;
+  model->version++;
 
   gtk_tree_model_row_deleted (GTK_TREE_MODEL (model), path);
   gtk_tree_path_free (path);
@@ -566,6 +573,8 @@ pointer_list_model_sort (PointerListModel *model, GCompareDataFunc sort_func)
 
   g_sequence_sort (pointers, sort_func, NULL);
 
+  model->version++;
+
   /* Generate new order. */
   new_order = g_new (int, length);
   for (i = 0; i < length; ++i)
@@ -636,6 +645,42 @@ pointer_list_model_get_pointers (PointerListModel *model)
   return g_list_reverse (list);
 }
 
+/* Copies at most n_pointers pointers, in order, into the caller's buffer
+ * and returns the number copied. Unlike get_pointers this doesn't allocate,
+ * so it is cheap enough to call on every change.
+ */
+int
+pointer_list_model_copy_pointers (PointerListModel *model,
+				  gpointer         *pointers,
+				  int               n_pointers)
+{
+  GSequenceIter *ptr;
+  int i = 0;
+
+  g_return_val_if_fail (IS_POINTER_LIST_MODEL (model), 0);
+
+  ptr = g_sequence_get_begin_iter (model->pointers);
+  while (i < n_pointers && !g_sequence_iter_is_end (ptr))
+    {
+      pointers[i++] = g_sequence_get (ptr);
+      ptr = g_sequence_iter_next (ptr);
+    }
+
+  return i;
+}
+
+/* The version is bumped whenever rows are added, removed or reordered,
+ * so callers can tell whether the contents changed since they last
+ * looked. Moving the current pointer doesn't count as a change.
+ */
+guint
+pointer_list_model_get_version (PointerListModel *model)
+{
+  g_return_val_if_fail (IS_POINTER_LIST_MODEL (model), 0);
+
+  return model->version;
+}
+
 gboolean
 pointer_list_model_contains (PointerListModel *model,
 			     gpointer          pointer)
@@ -659,6 +704,7 @@ remove_ptr (PointerListModel *model, GSequenceIter *ptr)
   g_sequence_remove (ptr);
 
   model->stamp++;
+  model->version++;
   
   gtk_tree_model_row_deleted (GTK_TREE_MODEL (model), path);
   gtk_tree_path_free (path);
@@ -768,6 +814,119 @@ pointer_list_model_set_current (PointerListModel *model, gpointer pointer)
   return TRUE;
 }
 
+typedef struct {
+  int            position;
+  GSequenceIter *ptr;
+} RemoveItem;
+
+static int
+remove_item_compare (const void *a, const void *b)
+{
+  const RemoveItem *item_a = a;
+  const RemoveItem *item_b = b;
+
+  return item_a->position - item_b->position;
+}
+
+/* Removes a batch of pointers in one go. Rows are deleted from the end of
+ * the list backwards, so every emitted row_deleted path is still valid for
+ * the rows that are left, and the version only moves once. If the current
+ * pointer is removed it moves to the first remaining row after it, or else
+ * to the last remaining row before it. Returns whether it moved.
+ */
+gboolean
+pointer_list_model_remove_pointers (PointerListModel *model,
+				    gpointer         *pointers,
+				    int               n_pointers)
+{
+  GHashTable *removed;
+  RemoveItem *items;
+  GSequenceIter *ptr, *new_current;
+  GtkTreePath *path;
+  gboolean current_changed = FALSE;
+  int n_items = 0;
+  int i;
+
+  g_return_val_if_fail (IS_POINTER_LIST_MODEL (model), FALSE);
+
+  if (n_pointers <= 0)
+    return FALSE;
+
+  removed = g_hash_table_new (NULL, NULL);
+  items = g_new (RemoveItem, n_pointers);
+
+  for (i = 0; i < n_pointers; i++)
+    {
+      ptr = g_hash_table_lookup (model->reverse_map, pointers[i]);
+      if (!ptr || g_hash_table_lookup (removed, ptr))
+	continue;
+
+      g_hash_table_insert (removed, ptr, GINT_TO_POINTER (TRUE));
+
+      items[n_items].position = g_sequence_iter_get_position (ptr);
+      items[n_items].ptr = ptr;
+      n_items++;
+    }
+
+  if (n_items == 0)
+    goto out;
+
+  /* Find the new current pointer while the old one is still around. */
+  if (model->current_pointer &&
+      g_hash_table_lookup (removed, model->current_pointer))
+    {
+      new_current = NULL;
+
+      ptr = g_sequence_iter_next (model->current_pointer);
+      while (!g_sequence_iter_is_end (ptr))
+	{
+	  if (!g_hash_table_lookup (removed, ptr))
+	    {
+	      new_current = ptr;
+	      break;
+	    }
+
+	  ptr = g_sequence_iter_next (ptr);
+	}
+
+      ptr = model->current_pointer;
+      while (new_current == NULL && !g_sequence_iter_is_begin (ptr))
+	{
+	  ptr = g_sequence_iter_prev (ptr);
+	  if (!g_hash_table_lookup (removed, ptr))
+	    new_current = ptr;
+	}
+
+      model->current_pointer = new_current;
+      current_changed = TRUE;
+    }
+
+  qsort (items, n_items, sizeof (RemoveItem), remove_item_compare);
+
+  model->stamp++;
+  model->version++;
+
+  for (i = n_items - 1; i >= 0; i--)
+    {
+      g_hash_table_remove (model->reverse_map, g_sequence_get (items[i].ptr));
+      g_sequence_remove (items[i].ptr);
+
+      path = gtk_tree_path_new ();
+      gtk_tree_path_append_index (path, items[i].position);
+      gtk_tree_model_row_deleted (GTK_TREE_MODEL (model), path);
+      gtk_tree_path_free (path);
+    }
+
+  if (current_changed)
+    row_changed (model, model->current_pointer);
+
+ out:
+  g_free (items);
+  g_hash_table_destroy (removed);
+
+  return current_changed;
+}
+
 gpointer
 pointer_list_model_next (PointerListModel *model)
 {
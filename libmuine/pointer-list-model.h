@@ -40,6 +40,8 @@ struct _PointerListModel {
   
   int              stamp;
 
+  guint            version;
+
   GCompareFunc     sort_func;
 
   GSequenceIter   *current_pointer;
@@ -65,6 +67,9 @@ void          pointer_list_model_remove         (PointerListModel *model,
 					         gpointer          pointer);
 void          pointer_list_model_remove_iter    (PointerListModel *model,
 					         GtkTreeIter      *iter);
+gboolean      pointer_list_model_remove_pointers (PointerListModel *model,
+						  gpointer         *pointers,
+						  int               n_pointers);
 void          pointer_list_model_clear          (PointerListModel *model);
 void          pointer_list_model_set_sorting    (PointerListModel *model,
 					         GCompareFunc      func);
@@ -76,6 +81,10 @@ gboolean      pointer_list_model_pointer_get_iter (PointerListModel *model,
 gpointer      pointer_list_model_iter_get_pointer (PointerListModel *model,
 					         GtkTreeIter      *iter);
 GList *       pointer_list_model_get_pointers   (PointerListModel *model);
+int           pointer_list_model_copy_pointers  (PointerListModel *model,
+						 gpointer         *pointers,
+						 int               n_pointers);
+guint         pointer_list_model_get_version    (PointerListModel *model);
 gboolean      pointer_list_model_contains       (PointerListModel *model,
 						 gpointer          pointer);
 void          pointer_list_model_remove_delta   (PointerListModel *model,
@@ -17,6 +17,10 @@ namespace Muine
 		private ArrayList filesToAdd = new ArrayList ();
 		private ArrayList filesToRemove = new ArrayList ();
 
+		// Paired moves, as { source, destination }
+		private ArrayList foldersToMove = new ArrayList ();
+		private ArrayList filesToMove = new ArrayList ();
+
 		public override void Initialize (IPlayer player)
 		{
 			if (!Inotify.Enabled)
@@ -55,15 +59,28 @@ namespace Muine
 					//Console.WriteLine ("Removing folder: " + folder);
 					player.RemoveFolder (folder);
 				}
+
+				// Rekey what we have, then pick up anything new
+				foreach (string [] move in foldersToMove)
+				{
+					Watch (move [1]);
+					player.MoveFolder (move [0], move [1]);
+					player.AddFolder (move [1]);
+				}
 				
 				foreach (string file in filesToAdd) player.AddSong (file);
 				
 				foreach (string file in filesToRemove) player.RemoveSong (file);
+
+				foreach (string [] move in filesToMove)
+					player.MoveSong (move [0], move [1]);
 				
 				foldersToAdd.Clear ();
 				foldersToRemove.Clear ();
+				foldersToMove.Clear ();
 				filesToAdd.Clear ();
 				filesToRemove.Clear ();
+				filesToMove.Clear ();
 			}
 		}
 
@@ -90,17 +107,17 @@ namespace Muine
 					if (HasFlag (type, Inotify.EventType.IsDirectory) &&
 					    !HasFlag (type, Inotify.EventType.CloseWrite))
 					{
-						foldersToAdd.Add (fullPath);
-						
 						if (srcpath != null)
-							foldersToRemove.Add (srcpath);
+							foldersToMove.Add (new string [] { srcpath, fullPath });
+						else
+							foldersToAdd.Add (fullPath);
 					}
 					else
 					{
-						filesToAdd.Add (fullPath);
-						
 						if (srcpath != null)
-							filesToRemove.Add (srcpath);
+							filesToMove.Add (new string [] { srcpath, fullPath });
+						else
+							filesToAdd.Add (fullPath);
 					}
 					
 				}
@@ -48,6 +48,12 @@ namespace Muine
 		private static readonly string string_import =
 			Catalog.GetString ("_Import Folder...");
 
+		private static readonly string string_rescan =
+			Catalog.GetString ("_Rescan Music Folders");
+
+		private static readonly string string_retry_covers =
+			Catalog.GetString ("Find _Missing Covers");
+
 		private static readonly string string_open =
 			Catalog.GetString ("_Open...");
 
@@ -121,6 +127,12 @@ namespace Muine
 			new ActionEntry ("Import", Stock.Execute, string_import,
 				null, null, null),
 
+			new ActionEntry ("Rescan", Stock.Refresh, string_rescan,
+				null, null, null),
+
+			new ActionEntry ("RetryCovers", null, string_retry_covers,
+				null, null, null),
+
 			new ActionEntry ("Open", Stock.Open, string_open,
 				"<control>O", null, null),
 
@@ -222,6 +234,8 @@ namespace Muine
 			
 			// Setup Callbacks
 			this ["Import"       ].Activated += OnImport;
+			this ["Rescan"       ].Activated += OnRescan;
+			this ["RetryCovers"  ].Activated += OnRetryCovers;
 			this ["Open"         ].Activated += OnOpen;
 			this ["Save"         ].Activated += OnSave;
 			this ["ToggleVisible"].Activated += OnToggleVisible;
@@ -240,6 +254,12 @@ namespace Muine
 			this ["About"        ].Activated += OnAbout;
 			this ["TogglePlay"   ].Activated += OnTogglePlay;
 			this ["ToggleRepeat" ].Activated += OnToggleRepeat;
+
+			Global.DB.CheckingChangesChanged += OnCheckingChangesChanged;
+
+			// Which albums have a cover isn't known until then
+			this ["RetryCovers"].Sensitive = !Global.CoverDB.Loading;
+			Global.CoverDB.DoneLoading += OnCoversDoneLoading;
 		}
 
 		// Properties
@@ -285,6 +305,70 @@ namespace Muine
 			new ImportDialog ();
 		}
 
+		// Handlers :: OnRescan
+		/// <summary>
+		/// 	Handler called when the Rescan action is activated.
+		/// </summary>
+		/// <remarks>
+		///	This checks every song and every directory in the
+		///	watched folders for changes, including the ones that
+		///	look unchanged.
+		/// </remarks>
+		/// <param name="o">
+		///	The calling object.
+		/// </param>
+		/// <param name="args">
+		///	The <see cref="EventArgs" />.
+		/// </param>
+		private void OnRescan (object o, EventArgs args)
+		{
+			Global.DB.CheckChanges (true);
+		}
+
+		// Handlers :: OnCheckingChangesChanged
+		/// <summary>
+		///	Handler called when a check for changes starts or
+		///	finishes.
+		/// </summary>
+		/// <remarks>
+		///	Rescanning can't be started while a check is running.
+		/// </remarks>
+		private void OnCheckingChangesChanged ()
+		{
+			this ["Rescan"].Sensitive = !Global.DB.CheckingChanges;
+		}
+
+		// Handlers :: OnCoversDoneLoading
+		/// <summary>
+		///	Handler called when the cover database is loaded.
+		/// </summary>
+		/// <remarks>
+		///	Covers can be looked up again from now on.
+		/// </remarks>
+		private void OnCoversDoneLoading ()
+		{
+			this ["RetryCovers"].Sensitive = true;
+		}
+
+		// Handlers :: OnRetryCovers
+		/// <summary>
+		/// 	Handler called when the RetryCovers action is activated.
+		/// </summary>
+		/// <remarks>
+		///	This looks up the covers of all albums without one,
+		///	also those which weren't found recently.
+		/// </remarks>
+		/// <param name="o">
+		///	The calling object.
+		/// </param>
+		/// <param name="args">
+		///	The <see cref="EventArgs" />.
+		/// </param>
+		private void OnRetryCovers (object o, EventArgs args)
+		{
+			Global.CoverDB.Getter.RetryMisses ();
+		}
+
 		// Handlers :: OnOpen
 		/// <summary>
 		/// 	Handler called when the Open action is activated.
@@ -109,12 +109,14 @@ namespace Muine
 			base.List.DragDataGet += OnDragDataGet;
 
 			// Setup handlers
-			Global.DB.AlbumAdded   += base.OnAdded;
-			Global.DB.AlbumChanged += base.OnChanged;
-			Global.DB.AlbumRemoved += base.OnRemoved;
+			Global.DB.AlbumsAdded   += base.OnItemsAdded;
+			Global.DB.AlbumsChanged += base.OnItemsChanged;
+			Global.DB.AlbumsRemoved += base.OnItemsRemoved;
 
 			Global.CoverDB.DoneLoading += OnCoversDoneLoading;
 
+			base.List.Vadjustment.ValueChanged += OnScrolled;
+
 			// Enable drag and drop if we're not busy loading covers.
 			if (!Global.CoverDB.Loading)
 				EnableDragDest ();
@@ -189,8 +191,9 @@ namespace Muine
 		// Methods :: Private :: GetCoverImage
 		private Gdk.Pixbuf GetCoverImage (Album album)
 		{
-			if (album.CoverImage != null)
-				return album.CoverImage;
+			Gdk.Pixbuf cover = album.CoverImage;
+			if (cover != null)
+				return cover;
 
 			if (Global.CoverDB.Loading)
 				return Global.CoverDB.DownloadingPixbuf;
@@ -244,6 +247,45 @@ namespace Muine
 			SetSelectionData (target, data, args);
 		}
 
+		// Methods :: Private :: PrefetchCovers
+		/// <summary>Has the covers of the visible albums decoded, and
+		///   those of a page of albums above and below them.</summary>
+		private void PrefetchCovers ()
+		{
+			Gtk.TreePath start, end;
+			if (!base.List.GetVisibleRange (out start, out end))
+				return;
+
+			int first = start.Indices [0];
+			int last  = end.Indices [0];
+			int page  = last - first + 1;
+
+			ArrayList keys = new ArrayList ();
+
+			// Visible first, then the next page, then the previous
+			AddCoverKeys (keys, first, last);
+			AddCoverKeys (keys, last + 1, last + page);
+			AddCoverKeys (keys, first - page, first - 1);
+
+			Global.CoverDB.Prefetch ((string []) keys.ToArray (typeof (string)));
+		}
+
+		// Methods :: Private :: AddCoverKeys
+		private void AddCoverKeys (ArrayList keys, int first, int last)
+		{
+			first = Math.Max (first, 0);
+			last  = Math.Min (last, base.List.Model.Length - 1);
+
+			for (int i = first; i <= last; i ++) {
+				Gtk.TreePath path = new Gtk.TreePath (new int [] { i });
+				IntPtr ptr = base.List.Model.HandleFromPath (path);
+
+				Album album = GetAlbum (ptr);
+				if (album != null)
+					keys.Add (album.Key);
+			}
+		}
+
 		// Methods :: Private :: SetCoverImage
 		private void SetCoverImage
 		  (Gtk.CellRendererPixbuf cell, Gtk.TreeIter iter)
@@ -294,6 +336,17 @@ namespace Muine
 		{
 			EnableDragDest ();
 			base.List.QueueDraw ();
+
+			PrefetchCovers ();
+		}
+
+		// Handlers :: OnScrolled
+		/// <summary>Handler called when the list is scrolled.</summary>
+		/// <remarks>Prefetches the covers around the new
+		///   position.</remarks>
+		private void OnScrolled (object o, EventArgs args)
+		{
+			PrefetchCovers ();
 		}
 
 		// Handlers :: OnDragDataGet
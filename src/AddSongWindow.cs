@@ -83,9 +83,9 @@ namespace Muine
 			base.List.DragDataGet += OnDragDataGet;
 
 			// Setup handlers
-			Global.DB.SongAdded   += base.OnAdded;
-			Global.DB.SongChanged += base.OnChanged;
-			Global.DB.SongRemoved += base.OnRemoved;
+			Global.DB.SongsAdded   += base.OnItemsAdded;
+			Global.DB.SongsChanged += base.OnItemsChanged;
+			Global.DB.SongsRemoved += base.OnItemsRemoved;
 		}
 
 
@@ -284,12 +284,65 @@ namespace Muine
 			list.HandleRemoved (item.Handle);
 		}
 #endregion Protected.Handlers.OnRemoved
+
+#region Protected.Handlers.OnItemsAdded
+		/// <summary>Handler called when several <see cref="Item" />s
+		///   are added at once.</summary>
+		/// <param name="items">The <see cref="Item" />s which have
+		///   been added.</param>
+		protected void OnItemsAdded (Item [] items)
+		{
+			bool [] fits = new bool [items.Length];
+			for (int i = 0; i < items.Length; i ++)
+				fits [i] = items [i].FitsCriteria (entry.SearchBits);
+
+			list.HandleAdded (Handles (items), fits);
+		}
+#endregion Protected.Handlers.OnItemsAdded
+
+#region Protected.Handlers.OnItemsChanged
+		/// <summary>Handler called when several <see cref="Item" />s
+		///   are changed at once.</summary>
+		/// <param name="items">The <see cref="Item" />s which have
+		///   been changed.</param>
+		protected void OnItemsChanged (Item [] items)
+		{
+			bool [] fits = new bool [items.Length];
+			for (int i = 0; i < items.Length; i ++)
+				fits [i] = items [i].FitsCriteria (entry.SearchBits);
+
+			list.HandleChanged (Handles (items), fits);
+		}
+#endregion Protected.Handlers.OnItemsChanged
+
+#region Protected.Handlers.OnItemsRemoved
+		/// <summary>Handler called when several <see cref="Item" />s
+		///   are removed at once.</summary>
+		/// <param name="items">The <see cref="Item" />s which have
+		///   been removed.</param>
+		protected void OnItemsRemoved (Item [] items)
+		{
+			list.HandleRemoved (Handles (items));
+		}
+#endregion Protected.Handlers.OnItemsRemoved
 #endregion Protected.Handlers
 #endregion Protected
 
 
 #region Private
 #region Private.Methods
+#region Private.Methods.Handles
+		/// <summary>The handles of <paramref name="items" />.</summary>
+		private static IntPtr [] Handles (Item [] items)
+		{
+			IntPtr [] handles = new IntPtr [items.Length];
+			for (int i = 0; i < items.Length; i ++)
+				handles [i] = items [i].Handle;
+
+			return handles;
+		}
+#endregion Private.Methods.Handles
+
 #region Private.Methods.Reset
 		/// <summary>Display the new results.</summary>
 		private void Reset ()
@@ -18,6 +18,7 @@
  */
 
 using System;
+using System.Collections;
 
 namespace Muine
 {
@@ -145,6 +146,91 @@ namespace Muine
 			SelectFirstIfNeeded ();	
 		}
 
+		// Methods :: Public :: HandleAdded
+		/// <summary>
+		/// 	Add the items given by <paramref name="ptrs" /> which
+		/// 	<paramref name="fits" />.
+		/// </summary>
+		/// <remarks>
+		///	This is used when several <see cref="Item" />s have been
+		///	added to the database at once.
+		/// </remarks>
+		/// <param name="ptrs">
+		/// 	<see cref="Item" /> handles to add.
+		/// </param>
+		/// <param name="fits">
+		/// 	Whether each item fits or not, as returned by
+		/// 	<see cref="Item.FitsCriteria" />.
+		/// </param>
+		public void HandleAdded (IntPtr [] ptrs, bool [] fits)
+		{
+			for (int i = 0; i < ptrs.Length; i ++) {
+				if (fits [i])
+					base.Model.Append (ptrs [i]);
+			}
+		}
+
+		// Methods :: Public :: HandleChanged
+		/// <summary>
+		/// 	Modify the items given by <paramref name="ptrs" />
+		/// 	which <paramref name="fits" />, and remove the others.
+		/// </summary>
+		/// <remarks>
+		///	This is used when several <see cref="Item" />s have been
+		///	changed at once.
+		/// </remarks>
+		/// <param name="ptrs">
+		/// 	<see cref="Item" /> handles.
+		/// </param>
+		/// <param name="fits">
+		/// 	Whether each item fits or not, as returned by
+		/// 	<see cref="Item.FitsCriteria" />.
+		/// </param>
+		public void HandleChanged (IntPtr [] ptrs, bool [] fits)
+		{
+			ArrayList remove = new ArrayList ();
+
+			for (int i = 0; i < ptrs.Length; i ++) {
+				IntPtr ptr = ptrs [i];
+
+				if (!fits [i]) {
+					remove.Add (ptr);
+					continue;
+				}
+
+				if (base.Model.Contains (ptr))
+					base.Model.Changed (ptr);
+				else
+					base.Model.Append (ptr);
+			}
+
+			if (remove.Count > 0) {
+				Type ptr_type = typeof (IntPtr);
+				base.Model.RemoveHandles ((IntPtr []) remove.ToArray (ptr_type));
+			}
+
+			SelectFirstIfNeeded ();	
+		}
+
+		// Methods :: Public :: HandleRemoved
+		/// <summary>
+		/// 	Remove the <see cref="Item" />s given by 
+		///	<paramref name="ptrs" />.
+		/// </summary>
+		/// <remarks>
+		///	This is used when several <see cref="Item" />s have been
+		///	removed at once.
+		/// </remarks>
+		/// <param name="ptrs">
+		/// 	<see cref="Item" /> handles to remove.
+		/// </param>
+		public void HandleRemoved (IntPtr [] ptrs)
+		{
+			base.Model.RemoveHandles (ptrs);
+
+			SelectFirstIfNeeded ();	
+		}
+
 		// Methods :: Private
 		// Methods :: Private :: SelectFirstIfNeeded
 		/// <summary>
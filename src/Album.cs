@@ -66,7 +66,6 @@ namespace Muine
 
 		// Objects
 		private IComparer  song_comparer = new SongComparer ();
-		private Gdk.Pixbuf cover_image;
 
 		// Variables
 		private string name;
@@ -78,6 +77,7 @@ namespace Muine
 		private int n_tracks;
 		private int total_n_tracks;
 		private bool complete = false;
+		private bool has_cover = false;
 		
 		// Constructor
 		/// <summary>
@@ -110,8 +110,8 @@ namespace Muine
 			base.handle = cur_ptr;
 
 			if (check_cover) {
-				cover_image = GetCover (initial_song);
-				initial_song.SetCoverImageQuiet (cover_image);
+				FindCover ();
+				has_cover = Global.CoverDB.HasCover (this.Key);
 			}
 		}
 
@@ -180,27 +180,19 @@ namespace Muine
 			get { return year; }
 		}
 
-		// Properties :: CoverImage (set; get;) (Item)
+		// Properties :: CoverImage (get;) (Item)
 		/// <summary>
 		///	The <see cref="Gdk.Pixbuf" /> of the cover.
 		/// </summary>
-		/// <param name="value">
-		///	A <see cref="Gdk.Pixbuf" /> for use as the cover.
-		/// </param>
+		/// <remarks>
+		///	The cover is decoded when it's first asked for, see
+		///	<see cref="CoverDatabase.GetCover" />.
+		/// </remarks>
 		/// <returns>
 		///	A <see cref="Gdk.Pixbuf" /> of the cover.
 		/// </returns>
 		public override Gdk.Pixbuf CoverImage {
-			set {
-				cover_image = value;
-
-				foreach (Song s in songs)
-					s.CoverImage = value;
-
-				Global.DB.EmitAlbumChanged (this);
-			}
-
-			get { return cover_image; }
+			get { return Global.CoverDB.GetCover (this.Key); }
 		}
 
 		// Properties :: Public (get;) (Item)
@@ -260,19 +252,13 @@ namespace Muine
 			lock (this) {
 			
 				// Cover
-				if (check_cover) {
-					if (cover_image == null && song.CoverImage != null) {
+				if (check_cover && !has_cover) {
+					has_cover = Global.CoverDB.HasCover (this.Key);
 
-						// This is to pick up any embedded album covers
+					// This is to pick up any embedded album covers
+					if (has_cover) {
 						changed = true;
 						songs_changed = true;
-				
-						cover_image = song.CoverImage;
-						foreach (Song s in Songs)
-							s.SetCoverImageQuiet (cover_image);
-
-					} else {
-						song.SetCoverImageQuiet (cover_image);
 					}
 				}
 
@@ -368,7 +354,8 @@ namespace Muine
 		/// </param>
 		public void SetCoverLocal (string file)
 		{
-			CoverImage = Global.CoverDB.Getter.GetLocal (this.Key, file);
+			Global.CoverDB.Getter.GetLocal (this.Key, file);
+			EmitCoverChanged ();
 		}
 
 		// Methods :: Public :: SetCoverWeb
@@ -380,8 +367,23 @@ namespace Muine
 		/// </param>
 		public void SetCoverWeb (string url)
 		{
-			CoverImage = Global.CoverDB.Getter.GetWeb (this.Key, url,
+			Global.CoverDB.Getter.GetWeb (this.Key, url,
 				new CoverGetter.GotCoverDelegate (OnGotCover));
+			EmitCoverChanged ();
+		}
+
+		// Methods :: Public :: EmitCoverChanged (Item)
+		/// <summary>
+		///	Tell the album and its songs that the cover changed.
+		/// </summary>
+		public override void EmitCoverChanged ()
+		{
+			has_cover = Global.CoverDB.HasCover (this.Key);
+
+			foreach (Song s in songs)
+				s.EmitCoverChanged ();
+
+			Global.DB.EmitAlbumChanged (this);
 		}
 
 		// Methods :: Public :: Deregister (Item)
@@ -637,46 +639,32 @@ namespace Muine
 			return changed;
 		}
 
-		// Methods :: Private :: GetCover
+		// Methods :: Private :: FindCover
 		/// <summary>
 		///	Try to add a cover to the album using a variety of methods.
 		/// </summary>
 		/// <remarks>
 		///	First, the Database is checked to see if a cover is 
-		///	already present. Then, the song given is checked for an
-		///	embedded image. Then, the directory is searched for a 
-		///	image file with a name commonly used for cover images.
-		///	Finally, if those methods fail, Amazon.com is searched.
+		///	already present. This includes an image embedded in
+		///	the first song, which it stored there when it was read.
+		///	Then, the directory is searched for a image file with a
+		///	name commonly used for cover images. Finally, if those
+		///	methods fail, Amazon.com is searched.
 		/// </remarks>
-		/// <param name="initial_song">
-		///	The <see cref="Song" /> which should be searched for
-		///	an embedded image.
-		/// </param>
-		/// <returns>
-		///	A <see cref="Gdk.Pixbuf" /> of the cover.
-		/// </returns>
-		private Pixbuf GetCover (Song initial_song)
+		private void FindCover ()
 		{
 			string key = this.Key;
-			Gdk.Pixbuf pixbuf;
 			
 			// Database
-			pixbuf = (Pixbuf) Global.CoverDB.Covers [key];
-			if (pixbuf != null)
-				return pixbuf;
-
-			// Embedded
-			pixbuf = initial_song.CoverImage;
-			if (pixbuf != null)
-				return pixbuf;
+			if (Global.CoverDB.HasCover (key))
+				return;
 
 			// Folder
-			pixbuf = Global.CoverDB.Getter.GetFolderImage (key, folder);
-			if (pixbuf != null)
-				return pixbuf;
+			if (Global.CoverDB.Getter.GetFolderImage (key, folder) != null)
+				return;
 
 			// Amazon
-			return Global.CoverDB.Getter.GetAmazon (this);
+			Global.CoverDB.Getter.GetAmazon (this);
 		}
 
 		// Methods :: Private :: HaveHalfAlbum
@@ -774,14 +762,14 @@ namespace Muine
 		///	Handler called when a cover has been found.
 		/// </summary>
 		/// <remarks>
-		///	Sets the cover to the new cover.
+		///	The new cover is in the database already; this shows it.
 		/// </remarks>
 		/// <param name="pixbuf">
-		///	A <see cref="Gdk.Pixbuf" /> of the new cover.
+		///	A <see cref="Gdk.Pixbuf" /> of the new cover, or null.
 		/// </param>
 		private void OnGotCover (Pixbuf pixbuf)
 		{
-			CoverImage = pixbuf;
+			EmitCoverChanged ();
 		}
 
 		// Internal Classes
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Text;
+
+namespace Muine
+{
+	/// <summary>
+	///	One page of Amazon search results, as it's kept in the
+	///	<see cref="ResponseCache" />.
+	/// </summary>
+	/// <remarks>
+	///	The first line holds the total number of pages, then
+	///	there's a line per product with its name and image URL,
+	///	separated by a tab.
+	/// </remarks>
+	public class AmazonSearchPage
+	{
+		// Variables
+		private int total_pages;
+		private string [] product_names;
+		private string [] image_urls;
+
+		// Constructor
+		/// <summary>
+		///	Create a new <see cref="AmazonSearchPage" />.
+		/// </summary>
+		/// <remarks>
+		///	Tabs and newlines in the names and URLs are replaced
+		///	by spaces, and missing ones by empty strings.
+		/// </remarks>
+		public AmazonSearchPage (int total_pages, string [] product_names,
+					 string [] image_urls)
+		{
+			this.total_pages = total_pages;
+
+			this.product_names = new string [product_names.Length];
+			this.image_urls    = new string [product_names.Length];
+
+			for (int i = 0; i < product_names.Length; i ++) {
+				this.product_names [i] = StripSeparators (product_names [i]);
+				this.image_urls    [i] = StripSeparators (image_urls [i]);
+			}
+		}
+
+		// Properties
+		// Properties :: TotalPages (get;)
+		public int TotalPages {
+			get { return total_pages; }
+		}
+
+		// Properties :: ProductNames (get;)
+		public string [] ProductNames {
+			get { return product_names; }
+		}
+
+		// Properties :: ImageUrls (get;)
+		public string [] ImageUrls {
+			get { return image_urls; }
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Parse
+		/// <summary>
+		///	Read a page back from the cache.
+		/// </summary>
+		/// <returns>
+		///	The page, or null if <paramref name="data" /> isn't
+		///	in the cache format.
+		/// </returns>
+		public static AmazonSearchPage Parse (string data)
+		{
+			string [] lines = data.Split ('\n');
+
+			int total_pages;
+
+			try {
+				total_pages = Convert.ToInt32 (lines [0]);
+			} catch (FormatException) {
+				return null;
+			} catch (OverflowException) {
+				return null;
+			}
+
+			string [] product_names = new string [lines.Length - 1];
+			string [] image_urls    = new string [lines.Length - 1];
+
+			for (int i = 1; i < lines.Length; i ++) {
+				string [] fields = lines [i].Split ('\t');
+
+				product_names [i - 1] = fields [0];
+				image_urls    [i - 1] = (fields.Length > 1) ? fields [1] : null;
+			}
+
+			return new AmazonSearchPage (total_pages, product_names,
+				image_urls);
+		}
+
+		// Methods :: Public :: ToString
+		/// <summary>
+		///	The page in the cache format.
+		/// </summary>
+		public override string ToString ()
+		{
+			StringBuilder data = new StringBuilder ();
+			data.Append (total_pages);
+
+			for (int i = 0; i < product_names.Length; i ++) {
+				data.Append ('\n');
+				data.Append (product_names [i]);
+				data.Append ('\t');
+				data.Append (image_urls [i]);
+			}
+
+			return data.ToString ();
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: StripSeparators
+		private static string StripSeparators (string s)
+		{
+			if (s == null)
+				return String.Empty;
+
+			return s.Replace ('\t', ' ').Replace ('\n', ' ');
+		}
+	}
+}
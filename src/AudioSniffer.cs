@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace Muine
+{
+	/// <summary>
+	///	Looks at the first bytes of a file to tell whether it
+	///	really is music, before the tag reader has a go at it.
+	/// </summary>
+	/// <remarks>
+	///	Knows MP3, AAC, FLAC, Ogg, MP4 and WavPack by their
+	///	signatures. Anything else is <see cref="Result.Unknown" />,
+	///	and left to the tag reader.
+	/// </remarks>
+	public static class AudioSniffer
+	{
+		// Enums
+		// Enums :: Result
+		public enum Result {
+			Unknown,
+			Audio,
+			NotAudio
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Check
+		[DllImport ("libmuine")]
+		private static extern Result audio_sniffer_check (string filename);
+
+		public static Result Check (string filename)
+		{
+			return audio_sniffer_check (filename);
+		}
+	}
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+
+using Gdk;
+
+namespace Muine
+{
+	/// <summary>
+	///	Decoded covers, up to a number of bytes of pixel data.
+	/// </summary>
+	/// <remarks>
+	///	When the budget is exceeded, the covers used least recently
+	///	are dropped first. Not thread safe; the
+	///	<see cref="CoverDatabase" /> locks around it.
+	/// </remarks>
+	public class CoverCache
+	{
+		// Objects
+		private Hashtable entries = new Hashtable ();
+
+		//	Most recently used first
+		private Entry head = null;
+		private Entry tail = null;
+
+		// Variables
+		private long budget;
+		private long size = 0;
+
+		// Constructor
+		/// <summary>
+		///	Create a new <see cref="CoverCache" />.
+		/// </summary>
+		/// <param name="budget">
+		///	The number of bytes of pixel data to keep at most.
+		/// </param>
+		public CoverCache (long budget)
+		{
+			this.budget = budget;
+		}
+
+		// Properties
+		// Properties :: Size (get;)
+		/// <summary>
+		///	The number of bytes of pixel data in the cache.
+		/// </summary>
+		public long Size {
+			get { return size; }
+		}
+
+		// Properties :: Count (get;)
+		public int Count {
+			get { return entries.Count; }
+		}
+
+		// Indexer
+		/// <summary>
+		///	The cover stored under <paramref name="key" />, or null.
+		///	A cover that is found counts as used.
+		/// </summary>
+		public Pixbuf this [string key] {
+			get {
+				Entry entry = (Entry) entries [key];
+				if (entry == null)
+					return null;
+
+				Unlink (entry);
+				LinkFirst (entry);
+
+				return entry.Pixbuf;
+			}
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Contains
+		public bool Contains (string key)
+		{
+			return entries.ContainsKey (key);
+		}
+
+		// Methods :: Public :: Add
+		/// <summary>
+		///	Store <paramref name="pixbuf" /> under
+		///	<paramref name="key" />, replacing what was there.
+		/// </summary>
+		public void Add (string key, Pixbuf pixbuf)
+		{
+			Remove (key);
+
+			Entry entry = new Entry (key, pixbuf);
+
+			entries [key] = entry;
+			LinkFirst (entry);
+			size += entry.Size;
+
+			// Keep the one just added, even if it's too big
+			while (size > budget && tail != entry)
+				Remove (tail.Key);
+		}
+
+		// Methods :: Public :: Remove
+		public void Remove (string key)
+		{
+			Entry entry = (Entry) entries [key];
+			if (entry == null)
+				return;
+
+			entries.Remove (key);
+			Unlink (entry);
+			size -= entry.Size;
+		}
+
+		// Methods :: Public :: Clear
+		public void Clear ()
+		{
+			entries.Clear ();
+			head = tail = null;
+			size = 0;
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: LinkFirst
+		private void LinkFirst (Entry entry)
+		{
+			entry.Prev = null;
+			entry.Next = head;
+
+			if (head != null)
+				head.Prev = entry;
+
+			head = entry;
+
+			if (tail == null)
+				tail = entry;
+		}
+
+		// Methods :: Private :: Unlink
+		private void Unlink (Entry entry)
+		{
+			if (entry.Prev != null)
+				entry.Prev.Next = entry.Next;
+			else
+				head = entry.Next;
+
+			if (entry.Next != null)
+				entry.Next.Prev = entry.Prev;
+			else
+				tail = entry.Prev;
+
+			entry.Prev = entry.Next = null;
+		}
+
+		// Internal Classes
+		// Internal Classes :: Entry
+		private class Entry
+		{
+			public string Key;
+			public Pixbuf Pixbuf;
+			public long   Size;
+
+			public Entry Prev = null;
+			public Entry Next = null;
+
+			// Constructor
+			public Entry (string key, Pixbuf pixbuf)
+			{
+				Key    = key;
+				Pixbuf = pixbuf;
+				Size   = (long) pixbuf.Rowstride * pixbuf.Height;
+			}
+		}
+	}
+}
@@ -20,14 +20,36 @@
 using System;
 using System.Collections;
 using System.IO;
+using System.Runtime.InteropServices;
+using System.Threading;
 
 using Gdk;
 
 namespace Muine
 {
 	// TODO: Inherit from Database
+	/// <summary>
+	///	The album covers, and covers of songs without an album.
+	/// </summary>
+	/// <remarks>
+	///	Only which covers exist is read at startup. A cover is
+	///	decoded when it's asked for with <see cref="GetCover" />,
+	///	or ahead of time with <see cref="Prefetch" />, and kept in a
+	///	<see cref="CoverCache" /> of limited size.
+	///
+	///	Identical covers are stored once. The pixels are stored
+	///	under a hash of themselves, and each album key or
+	///	filename refers to a hash. The pixels are deleted when the
+	///	last key referring to them is removed. The cache is keyed
+	///	by hash too, so identical covers share one
+	///	<see cref="Gdk.Pixbuf" />.
+	/// </remarks>
 	public class CoverDatabase 
 	{
+		// GConf
+		private const string GConfKeyCacheSize = "/apps/muine/cover_cache_size";
+		private const int GConfDefaultCacheSize = 8192; // KB
+
 		// Constants
 		// Constants :: CoverSize
 		/// <remarks>
@@ -36,19 +58,80 @@ namespace Muine
 		/// </remarks>
 		public const int CoverSize = 66;
 
+		// Constants :: PixelsKeyPrefix
+		//	Album keys and filenames are absolute paths, so they
+		//	can't start with this.
+		private const string PixelsKeyPrefix = "pixels:";
+
+		// Constants :: ReorganizeKey
+		//	Stored after covers were repacked, to shrink the file
+		//	during the next load. Not a path either.
+		private const string ReorganizeKey = "reorganize";
+
+		// Constants :: MaxRepackWorkers
+		private const int MaxRepackWorkers = 4;
+
+		// Constants :: BusyTimeout
+		//	Milliseconds GetCover waits for the lock, enough for
+		//	others to read or write a record
+		private const int BusyTimeout = 20;
+
+		// Constants :: RetryDelay
+		//	Milliseconds after which covers asked for while the
+		//	database was busy are asked for again
+		private const uint RetryDelay = 100;
+
+		// Enums
+		// Enums :: State
+		private enum State {
+			Stored,
+			BeingChecked,
+			Downloading // like BeingChecked, but not stored
+		}
+
+		// Enums :: RecordKind
+		//	The first value in a record. Inline and BeingChecked
+		//	match the bool older versions stored there.
+		private enum RecordKind {
+			Inline,       // the pixels follow
+			BeingChecked,
+			Reference     // the hash of the pixels follows
+		}
+
 		// Events
 		public delegate void DoneLoadingHandler ();
 		public event         DoneLoadingHandler DoneLoading;
 
 		// Objects
+		//	Album key or filename => State
 		private Hashtable covers;
+
+		//	Album key or filename => hash, for stored covers.
+		//	Covers still stored inline by older versions have none
+		//	until they're repacked.
+		private Hashtable hashes;
+
+		//	Hash => number of keys referring to it
+		private Hashtable refs;
+
+		//	Hash, or key for inline covers => Pixbuf
+		private CoverCache cache;
 		private Pixbuf downloading_pixbuf;
 		private CoverGetter getter;
 		private Database db;	
+		private PrefetchThread prefetcher = null;
 
 		// Variables
 		private bool loading = true;
 
+
+		//	Set by CopyCover
+		private byte [] fetched = null;
+
+		//	Keys whose cover was asked for while the database was
+		//	busy. Only used from the main loop.
+		private Hashtable deferred = new Hashtable ();
+
 		// Constructor
 		/// <summary>
 		///	Create a <see cref="CoverDatabase"/ > object.
@@ -61,6 +144,13 @@ namespace Muine
 			db = new Database (FileUtils.CoversDBFile, version);
 
 			covers = new Hashtable ();
+			hashes = new Hashtable ();
+			refs   = new Hashtable ();
+
+			int cache_size = (int) Config.Get (GConfKeyCacheSize,
+				GConfDefaultCacheSize);
+
+			cache = new CoverCache ((long) cache_size * 1024);
 
 			// Hack to get the GtkStyle
 			Gtk.Label label = new Gtk.Label (String.Empty);
@@ -76,19 +166,6 @@ namespace Muine
 		}
 
 		// Properties
-		// Properties :: Covers (get;)
-		/// <summary>
-		///	The covers in the database.
-		/// </summary>
-		/// <returns>
-		///	A <see cref="Hashtable" /> of the covers in the 
-		///	database in the format of:
-		///	album key => <see cref="Gdk.Pixbuf" />.
-		/// </returns>
-		public Hashtable Covers {
-			get { return covers; }
-		}
-
 		// Properties :: DownloadingPixbuf (get;)
 		/// <summary>
 		///	The <see cref="Gdk.Pixbuf" /> which is used as a
@@ -139,6 +216,72 @@ namespace Muine
 			new LoadThread (db);
 		}
 
+		// Methods :: Public :: HasCover
+		/// <summary>
+		///	Whether a cover is stored under <paramref name="key" />.
+		/// </summary>
+		/// <remarks>
+		///	Covers which are still being looked for don't count.
+		/// </remarks>
+		/// <param name="key">
+		///	The album key, or filename.
+		/// </param>
+		public bool HasCover (string key)
+		{
+			object state = covers [key];
+
+			return (state != null && (State) state == State.Stored);
+		}
+
+		// Methods :: Public :: GetCover
+		/// <summary>
+		///	The cover stored under <paramref name="key" />.
+		/// </summary>
+		/// <remarks>
+		///	Decodes the cover if it isn't cached. This is called
+		///	from the main loop, so it doesn't wait while the
+		///	database is busy, as it is while the file is being
+		///	shrunk after loading. The album or song is told that its
+		///	cover changed once the database is free again.
+		/// </remarks>
+		/// <param name="key">
+		///	The album key, or filename.
+		/// </param>
+		/// <returns>
+		///	A <see cref="Gdk.Pixbuf" />, <see cref="DownloadingPixbuf" />
+		///	while the cover is being looked for or the database is
+		///	busy, or null if there is no cover, or the database is
+		///	still being loaded.
+		/// </returns>
+		public Pixbuf GetCover (string key)
+		{
+			if (loading)
+				return null;
+
+			return LoadCover (key, false);
+		}
+
+		// Methods :: Public :: Prefetch
+		/// <summary>
+		///	Decode the covers stored under <paramref name="keys" />
+		///	in the background, so they're cached when they're
+		///	asked for.
+		/// </summary>
+		/// <remarks>
+		///	Replaces the keys of earlier calls which weren't
+		///	handled yet.
+		/// </remarks>
+		public void Prefetch (string [] keys)
+		{
+			if (loading)
+				return;
+
+			if (prefetcher == null)
+				prefetcher = new PrefetchThread (this);
+
+			prefetcher.Add (keys);
+		}
+
 		// Methods :: Public :: SetCover
 		/// <summary>
 		///	Store a cover in the database.
@@ -147,21 +290,39 @@ namespace Muine
 		///	The album key.
 		/// </param>
 		/// <param name="pix">
-		///	The <see cref="Gdk.Pixbuf" /> to be used for the cover.
+		///	The <see cref="Gdk.Pixbuf" /> to be used for the cover,
+		///	or null to mark it as being checked.
 		/// </param>
 		public void SetCover (string key, Pixbuf pix)
 		{
 			lock (this) {
-				bool replace = Covers.ContainsKey (key);
+				bool replace = covers.ContainsKey (key);
 
-				if (replace)
-					Covers.Remove (key);
+				Release (key);
 
-				Covers.Add (key, pix);
+				if (pix == null) {
+					covers [key] = State.BeingChecked;
 
-				int data_size;
-				IntPtr data = PackCover (pix, out data_size);
-				db.Store (key, data, data_size, replace);
+					int data_size;
+					IntPtr data = PackCover (null, out data_size);
+					db.Store (key, data, data_size, replace);
+
+					return;
+				}
+
+				string hash = Hash (pix);
+
+				if (!refs.ContainsKey (hash)) {
+					int data_size;
+					IntPtr data = PackCover (pix, out data_size);
+					db.Store (PixelsKey (hash), data, data_size, true);
+				}
+
+				// Keep the Pixbuf that's shared already
+				if (!cache.Contains (hash))
+					cache.Add (hash, pix);
+
+				SetReference (key, hash, replace);
 			}
 		}
 
@@ -175,11 +336,55 @@ namespace Muine
 		public void RemoveCover (string key)
 		{
 			lock (this) {
-				if (!Covers.ContainsKey (key))
+				object state = covers [key];
+				if (state == null)
 					return;
 
-				db.Delete (key);
-				Covers.Remove (key);
+				if ((State) state != State.Downloading)
+					db.Delete (key);
+
+				Release (key);
+				covers.Remove (key);
+			}
+		}
+
+		// Methods :: Public :: MoveCover
+		/// <summary>
+		///	Store the cover of <paramref name="old_key" /> under
+		///	<paramref name="new_key" />, unless that has one already.
+		/// </summary>
+		/// <param name="old_key">
+		///	The album key, or filename, the cover is stored under.
+		/// </param>
+		/// <param name="new_key">
+		///	The album key, or filename, to store the cover under.
+		/// </param>
+		/// <param name="keep_old">
+		///	Whether <paramref name="old_key" /> keeps its cover too.
+		/// </param>
+		public void MoveCover (string old_key, string new_key, bool keep_old)
+		{
+			lock (this) {
+				if (HasCover (old_key) && !HasCover (new_key)) {
+					string hash = (string) hashes [old_key];
+
+					if (hash != null) {
+						// Share the pixels, no need to decode
+						bool replace = covers.ContainsKey (new_key);
+
+						Release (new_key);
+						SetReference (new_key, hash, replace);
+
+					} else {
+						Pixbuf pix = LoadCover (old_key, true);
+
+						if (pix != null)
+							SetCover (new_key, pix);
+					}
+				}
+
+				if (!keep_old)
+					RemoveCover (old_key);
 			}
 		}
 
@@ -215,8 +420,174 @@ namespace Muine
 		{
 			RemoveCover (key);
 		}
+
+		// Methods :: Public :: MarkAsDownloading
+		/// <summary>
+		///	Removes the cover, and shows <see cref="DownloadingPixbuf" />
+		///	instead until a new one is set.
+		/// </summary>
+		/// <remarks>
+		///	Unlike <see cref="MarkAsBeingChecked" />, this isn't
+		///	remembered across sessions. Unmark with
+		///	<see cref="UnmarkAsDownloading" /> if no cover is found.
+		/// </remarks>
+		/// <param name="key">
+		///	The album key, or filename.
+		/// </param>
+		public void MarkAsDownloading (string key)
+		{
+			lock (this) {
+				RemoveCover (key);
+
+				covers [key] = State.Downloading;
+			}
+		}
+
+		// Methods :: Public :: UnmarkAsDownloading
+		public void UnmarkAsDownloading (string key)
+		{
+			lock (this) {
+				object state = covers [key];
+
+				if (state != null && (State) state == State.Downloading)
+					covers.Remove (key);
+			}
+		}
 				
 		// Methods :: Private
+		// Methods :: Private :: LoadCover
+		//	Returns the cover from the cache, or decodes and caches
+		//	it. The lock is only taken to read the record and to
+		//	cache the cover, not while decoding. Unless wait is set,
+		//	a busy database defers the cover, see Defer.
+		private Pixbuf LoadCover (string key, bool wait)
+		{
+			string cache_key;
+			byte [] data;
+
+			if (!Lock (wait)) {
+				Defer (key);
+				return downloading_pixbuf;
+			}
+
+			try {
+				object state = covers [key];
+				if (state == null)
+					return null;
+
+				if ((State) state != State.Stored)
+					return downloading_pixbuf;
+
+				cache_key = CacheKey (key);
+
+				Pixbuf cached = cache [cache_key];
+				if (cached != null)
+					return cached;
+
+				data = FetchCover (RecordKey (key));
+
+			} finally {
+				Monitor.Exit (this);
+			}
+
+			Pixbuf pixbuf = DecodeCover (data);
+			if (pixbuf == null)
+				return null;
+
+			// Not cached then, but decoded all the same
+			if (!Lock (wait))
+				return pixbuf;
+
+			try {
+				// Decoded by someone else meanwhile
+				Pixbuf cached = cache [cache_key];
+				if (cached != null)
+					return cached;
+
+				// Don't cache it if it was replaced meanwhile
+				if (HasCover (key) && CacheKey (key) == cache_key)
+					cache.Add (cache_key, pixbuf);
+
+			} finally {
+				Monitor.Exit (this);
+			}
+
+			return pixbuf;
+		}
+
+		// Methods :: Private :: Lock
+		//	Takes the lock, or returns false if it's held by
+		//	someone else for long and wait isn't set.
+		private bool Lock (bool wait)
+		{
+			if (!wait)
+				return Monitor.TryEnter (this, BusyTimeout);
+
+			Monitor.Enter (this);
+			return true;
+		}
+
+		// Methods :: Private :: Defer
+		//	Remembers a key whose cover couldn't be looked up, to
+		//	have it asked for again once the database is free.
+		private void Defer (string key)
+		{
+			if (deferred.Count == 0) {
+				GLib.Timeout.Add (RetryDelay,
+					new GLib.TimeoutHandler (OnRetryDeferred));
+			}
+
+			deferred [key] = true;
+		}
+
+		// Methods :: Private :: CacheKey
+		//	Call with the lock held.
+		private string CacheKey (string key)
+		{
+			string hash = (string) hashes [key];
+
+			return (hash != null) ? hash : key;
+		}
+
+		// Methods :: Private :: RecordKey
+		//	The record the pixels are in. Call with the lock held.
+		private string RecordKey (string key)
+		{
+			string hash = (string) hashes [key];
+
+			return (hash != null) ? PixelsKey (hash) : key;
+		}
+
+		// Methods :: Private :: FetchCover
+		//	Copies the packed pixels out of a record, or returns
+		//	null. Call with the lock held.
+		private byte [] FetchCover (string key)
+		{
+			fetched = null;
+
+			db.Fetch (key, new Database.DecodeFunctionDelegate (CopyCover));
+
+			byte [] data = fetched;
+			fetched = null;
+
+			return data;
+		}
+
+		// Methods :: Private :: DecodeCover
+		//	Decodes pixels copied with FetchCover. Doesn't need
+		//	the lock.
+		private static Pixbuf DecodeCover (byte [] data)
+		{
+			if (data == null)
+				return null;
+
+			IntPtr pix_handle = Database.DecodePixbuf (data);
+			if (pix_handle == IntPtr.Zero)
+				return null;
+
+			return new Pixbuf (pix_handle);
+		}
+
 		// Methods :: Private :: PackCover
 		/// <summary>
 		///	Pack cover into a format which can be stored in the database.
@@ -234,16 +605,99 @@ namespace Muine
 		{
 			IntPtr p = Database.PackStart ();
 
-			bool being_checked = (pixbuf == null);
-			
-			Database.PackBool (p, being_checked);
+			if (pixbuf == null) {
+				Database.PackInt (p, (int) RecordKind.BeingChecked);
 
-			if (!being_checked)
+			} else {
+				Database.PackInt    (p, (int) RecordKind.Inline);
 				Database.PackPixbuf (p, pixbuf.Handle);
+			}
+
+			return Database.PackEnd (p, out length);
+		}
+
+		// Methods :: Private :: PackReference
+		private IntPtr PackReference (string hash, out int length)
+		{
+			IntPtr p = Database.PackStart ();
+
+			Database.PackInt    (p, (int) RecordKind.Reference);
+			Database.PackString (p, hash);
 
 			return Database.PackEnd (p, out length);
 		}
 
+		// Methods :: Private :: SetReference
+		//	Stores key as referring to hash, which must have its
+		//	pixels stored. Call with the lock held, after
+		//	releasing what key referred to.
+		private void SetReference (string key, string hash, bool replace)
+		{
+			covers [key] = State.Stored;
+			hashes [key] = hash;
+
+			AddRef (hash);
+
+			int data_size;
+			IntPtr data = PackReference (hash, out data_size);
+			db.Store (key, data, data_size, replace);
+		}
+
+		// Methods :: Private :: AddRef
+		private void AddRef (string hash)
+		{
+			object n = refs [hash];
+
+			refs [hash] = (n == null) ? 1 : (int) n + 1;
+		}
+
+		// Methods :: Private :: Release
+		//	Drops the reference key holds, and deletes the pixels
+		//	if it was the last one. Call with the lock held.
+		private void Release (string key)
+		{
+			string hash = (string) hashes [key];
+
+			// Inline covers are cached under their key
+			cache.Remove (key);
+
+			if (hash == null)
+				return;
+
+			hashes.Remove (key);
+
+			object n_refs = refs [hash];
+			if (n_refs == null)
+				return;
+
+			int n = (int) n_refs - 1;
+
+			if (n > 0) {
+				refs [hash] = n;
+				return;
+			}
+
+			refs.Remove (hash);
+			cache.Remove (hash);
+
+			db.Delete (PixelsKey (hash));
+		}
+
+		// Methods :: Private :: Hash
+		[DllImport ("libmuine")]
+		private static extern ulong cover_hash (IntPtr pixbuf);
+
+		private static string Hash (Pixbuf pixbuf)
+		{
+			return cover_hash (pixbuf.Handle).ToString ("x16");
+		}
+
+		// Methods :: Private :: PixelsKey
+		private static string PixelsKey (string hash)
+		{
+			return PixelsKeyPrefix + hash;
+		}
+
 		// Methods :: Private :: EmitDoneLoading
 		/// <summary>
 		///	Calls the handler for the <see cref="DoneLoading" />
@@ -257,29 +711,89 @@ namespace Muine
 				DoneLoading ();
 		}
 
-		// Internal Classes
-		// Internal Classes :: LoadThread
-		// 	FIXME: Split off? This is big.
-		private class LoadThread : ThreadBase
+		// Handlers
+		// Handlers :: OnRetryDeferred
+		//	Tells the albums and songs whose cover was deferred
+		//	that it changed, so they ask for it again.
+		private bool OnRetryDeferred ()
 		{
-			// Structs
-			/// <summary>
-			///	A structure representing a loaded cover.
-			/// </summary>
-			private struct LoadedCover {
-				public Pixbuf Pixbuf;
-				public Item Item;
-
-				public LoadedCover (Item item, Pixbuf pixbuf)
-				{
-					Item   = item;
-					Pixbuf = pixbuf;
+			// Still busy
+			if (!Monitor.TryEnter (this))
+				return true;
+
+			Monitor.Exit (this);
+
+			Hashtable keys = deferred;
+			deferred = new Hashtable ();
+
+			foreach (string key in keys.Keys) {
+				Album album = Global.DB.GetAlbum (key);
+				if (album != null) {
+					album.EmitCoverChanged ();
+					continue;
 				}
+
+				Song song = Global.DB.GetSong (key);
+				if (song != null)
+					song.EmitCoverChanged ();
 			}
 
+			return false;
+		}
+
+		// Delegate Functions
+		// Delegate Functions :: CopyCover
+		//   (Database.DecodeFunctionDelegate)
+		private void CopyCover (string key, IntPtr data)
+		{
+			IntPtr p = data;
+
+			int kind;
+			p = Database.UnpackInt (p, out kind);
+
+			if ((RecordKind) kind != RecordKind.Inline)
+				return;
+
+			p = Database.UnpackPixbufData (p, out fetched);
+		}
+
+		// Internal Classes
+		// Internal Classes :: LoadThread
+		/// <summary>
+		///	Reads which covers there are, without decoding them.
+		/// </summary>
+		/// <remarks>
+		///	The database is only locked while it's read. Loading is
+		///	done as soon as that's finished; the file is shrunk
+		///	afterwards if it was marked for it, and covers stored by
+		///	older versions are converted, by a few workers which
+		///	decode, hash and compress them in parallel and only take
+		///	the lock to read and write records.
+		/// </remarks>
+		private class LoadThread : ThreadBase
+		{
 			// Variables
 			private Database db;			
 
+			//	Index of the last cover in to_repack taken by
+			//	a worker
+			private int repack_index = -1;
+
+			//	Whether the last session repacked covers
+			private bool reorganize = false;
+
+			private int n_repacked = 0;
+
+			//	Covers stored inline by older versions
+			private ArrayList to_repack = new ArrayList ();
+
+			//	Hashes whose pixels are stored
+			private Hashtable pixels = new Hashtable ();
+
+			//	Lookups left unfinished, which aren't done again
+			//	as they were tried recently
+			private ArrayList to_unmark = new ArrayList ();
+
 			// Constructor
 			/// <summary>
 			///	Create a new <see cref="LoadThread"/ > object.
@@ -306,43 +820,221 @@ namespace Muine
 			/// </remarks>
 			protected override void ThreadFunc ()
 			{
+				CoverDatabase cover_db = Global.CoverDB;
+
 				Database.DecodeFunctionDelegate func =
 				  new Database.DecodeFunctionDelegate (DecodeFunction);
 
-				lock (Global.CoverDB)
+				DateTime start = DateTime.Now;
+
+				lock (cover_db) {
 					db.Load (func);
 
-				thread_done = true;
+					foreach (string key in to_unmark)
+						db.Delete (key);
+
+					RemoveDangling ();
+				}
+
+				DebugLog.Write ("covers: {0} read in {1:0} ms",
+					cover_db.covers.Count,
+					(DateTime.Now - start).TotalMilliseconds);
+
+				// Tells the main loop loading is done
+				Enqueue (this);
+
+				// Rewrites the whole file, which holds the lock
+				// a while. GetCover doesn't wait for it.
+				if (reorganize) {
+					start = DateTime.Now;
+
+					lock (cover_db) {
+						db.Delete (ReorganizeKey);
+						db.Reorganize ();
+					}
+
+					DebugLog.Write ("covers: reorganized in {0:0} ms",
+						(DateTime.Now - start).TotalMilliseconds);
+				}
+
+				if (to_repack.Count > 0) {
+					start = DateTime.Now;
+
+					Repack ();
+
+					DebugLog.Write ("covers: {0} of {1} repacked in {2:0} ms",
+						n_repacked, to_repack.Count,
+						(DateTime.Now - start).TotalMilliseconds);
+				}
+			}
+
+			// Methods
+			// Methods :: Protected
+			// Methods :: Protected :: HandleItem (ThreadBase)
+			//	The only item is queued when the scan is done;
+			//	covers are decoded when they're asked for.
+			protected override void HandleItem (object item)
+			{
+				Global.CoverDB.EmitDoneLoading ();
+			}
+
+			// Methods :: Protected :: Finished (ThreadBase)
+			//	In case the scan failed before it got to tell.
+			protected override void Finished ()
+			{
+				if (Global.CoverDB.Loading)
+					Global.CoverDB.EmitDoneLoading ();
+			}
+
+			// Methods :: Private
+			// Methods :: Private :: RemoveDangling
+			//	Deletes references to pixels which aren't stored,
+			//	and pixels nothing refers to, as left by a crash.
+			//	Call with the lock held.
+			private void RemoveDangling ()
+			{
+				CoverDatabase cover_db = Global.CoverDB;
+
+				ArrayList dangling = new ArrayList ();
+
+				foreach (DictionaryEntry de in cover_db.hashes) {
+					if (!pixels.ContainsKey (de.Value))
+						dangling.Add (de.Key);
+				}
+
+				foreach (string key in dangling) {
+					cover_db.refs.Remove (cover_db.hashes [key]);
+					cover_db.hashes.Remove (key);
+					cover_db.covers.Remove (key);
+
+					db.Delete (key);
+				}
+
+				foreach (string hash in pixels.Keys) {
+					if (!cover_db.refs.ContainsKey (hash))
+						db.Delete (PixelsKey (hash));
+				}
 			}
 
-			// Delegate Functions :: MainLoopIdle (ThreadBase)
+			// Methods :: Private :: Repack
 			/// <summary>
-			///	Adds the covers from the queue to their 
-			///	associated albums.
+			///	Store the covers in <see cref="to_repack" /> again,
+			///	by hash and compressed. The database is shrunk on
+			///	the next load.
 			/// </summary>
 			/// <remarks>
-			///	This runs from GLib's main loop.
+			///	The records can't be replaced while the database
+			///	is being read, so this runs after loading. Workers
+			///	take covers by bumping a shared index, so they
+			///	don't need a lock to find the next one.
 			/// </remarks>
-			/// <returns>
-			///	True if the loop should continue,
-			///	False if it should stop.
-			/// </returns>
-			protected override bool MainLoopIdle ()
+			private void Repack ()
 			{
-				if (queue.Count == 0) {
-					if (thread_done) {
-						Global.CoverDB.EmitDoneLoading ();						
-						return false;
+				int n_workers = Environment.ProcessorCount;
+				n_workers = Math.Max (1, Math.Min (n_workers, MaxRepackWorkers));
+
+				Thread [] workers = new Thread [n_workers];
+
+				for (int i = 0; i < n_workers; i ++) {
+					workers [i] = new Thread (new ThreadStart (RepackWorkerFunc));
+					workers [i].IsBackground = true;
+					workers [i].Priority = ThreadPriority.BelowNormal;
+					workers [i].Start ();
+				}
+
+				foreach (Thread worker in workers)
+					worker.Join ();
+
+				// The replaced records leave holes in the file,
+				// which are dropped on the next load
+				lock (Global.CoverDB)
+					MarkForReorganize ();
+			}
+
+			// Methods :: Private :: MarkForReorganize
+			//	Call with the lock held.
+			private void MarkForReorganize ()
+			{
+				IntPtr p = Database.PackStart ();
+				Database.PackBool (p, true);
+
+				int data_size;
+				IntPtr data = Database.PackEnd (p, out data_size);
+				db.Store (ReorganizeKey, data, data_size, true);
+			}
+
+			// Methods :: Private :: RepackCover
+			//	Reading the record takes the lock. Decoding,
+			//	hashing and compressing don't.
+			private void RepackCover (string key)
+			{
+				CoverDatabase cover_db = Global.CoverDB;
+
+				byte [] packed;
+
+				lock (cover_db) {
+					// Changed meanwhile
+					if (!cover_db.HasCover (key) ||
+					    cover_db.hashes.ContainsKey (key))
+						return;
+
+					packed = cover_db.FetchCover (key);
+				}
+
+				Pixbuf pixbuf = DecodeCover (packed);
+				if (pixbuf == null)
+					return;
+
+				string hash = Hash (pixbuf);
+
+				bool stored;
+				lock (cover_db)
+					stored = cover_db.refs.ContainsKey (hash);
+
+				IntPtr data = IntPtr.Zero;
+				int data_size = 0;
+
+				if (!stored)
+					data = cover_db.PackCover (pixbuf, out data_size);
+
+				lock (cover_db) {
+					// The store frees the data, so it's
+					// stored even if it's not needed anymore
+					if (data != IntPtr.Zero)
+						db.Store (PixelsKey (hash), data, data_size, true);
+
+					if (!cover_db.HasCover (key) ||
+					    cover_db.hashes.ContainsKey (key)) {
+						if (!cover_db.refs.ContainsKey (hash))
+							db.Delete (PixelsKey (hash));
+
+						return;
 					}
 
-					return true;
+					// Released by all others meanwhile
+					if (data == IntPtr.Zero &&
+					    !cover_db.refs.ContainsKey (hash)) {
+						data = cover_db.PackCover (pixbuf, out data_size);
+						db.Store (PixelsKey (hash), data, data_size, true);
+					}
+
+					cover_db.Release (key);
+					cover_db.SetReference (key, hash, true);
+
+					if (!cover_db.cache.Contains (hash))
+						cover_db.cache.Add (hash, pixbuf);
+
+					n_repacked ++;
 				}
+			}
 
-				LoadedCover lc = (LoadedCover) queue.Dequeue ();
-			
-				lc.Item.CoverImage = lc.Pixbuf;
+			// Delegate Functions :: RepackWorkerFunc
+			private void RepackWorkerFunc ()
+			{
+				int i;
 
-				return true;
+				while ((i = Interlocked.Increment (ref repack_index)) < to_repack.Count)
+					RepackCover ((string) to_repack [i]);
 			}
 
 			// Delegate Functions :: DecodeFunction
@@ -358,50 +1050,115 @@ namespace Muine
 			/// </param>
 			private void DecodeFunction (string key, IntPtr data)
 			{
+				CoverDatabase cover_db = Global.CoverDB;
 				IntPtr p = data;
 
-				bool being_checked;
-				p = Database.UnpackBool (p, out being_checked);
-		
-				Pixbuf pixbuf = null;
-				if (!being_checked) {
-					IntPtr pix_handle;
-					p = Database.UnpackPixbuf (p, out pix_handle);
-					pixbuf = new Pixbuf (pix_handle);
+				if (key == ReorganizeKey) {
+					reorganize = true;
+					return;
 				}
 
-				if (Global.CoverDB.Covers.Contains (key)) {
-					if (being_checked)
-						return;
-					
-					// stored covers take priority
-					Global.CoverDB.Covers.Remove (key);
+				if (key.StartsWith (PixelsKeyPrefix)) {
+					pixels [key.Substring (PixelsKeyPrefix.Length)] = true;
+					return;
 				}
+
+				int kind;
+				p = Database.UnpackInt (p, out kind);
+
+				// stored covers take priority
+				if ((RecordKind) kind == RecordKind.BeingChecked &&
+				    cover_db.covers.Contains (key))
+					return;
 				
-				// Add independent of whether item is null or not,
-				// this way manually set covers will stay for
-				// removable devices.
-				if (!being_checked) 
-					Global.CoverDB.Covers.Add (key, pixbuf);
-
-				Item item = Global.DB.GetAlbum (key);
-				if (item == null)
-					item = Global.DB.GetSong (key);
-
-				if (item != null) {
-					if (being_checked) {
-						// false, as we don't want to write to the db
-						// while we're loading
-						Album album = (Album) item;
-
-						pixbuf =
-						  Global.CoverDB.Getter.GetAmazon (album, false);
-
-						Global.CoverDB.Covers.Add (key, null);
+				// Add independent of whether there is an item for
+				// it or not, this way manually set covers will stay
+				// for removable devices.
+				if ((RecordKind) kind == RecordKind.Inline) {
+					to_repack.Add (key);
+
+					cover_db.covers [key] = State.Stored;
+					return;
+				}
+
+				if ((RecordKind) kind == RecordKind.Reference) {
+					string hash;
+					p = Database.UnpackString (p, out hash);
+
+					cover_db.covers [key] = State.Stored;
+					cover_db.hashes [key] = hash;
+					cover_db.AddRef (hash);
+					return;
+				}
+
+				Album album = Global.DB.GetAlbum (key);
+				if (album == null)
+					return;
+
+				// false, as we don't want to write to the db
+				// while we're loading
+				cover_db.covers [key] = State.BeingChecked;
+
+				if (cover_db.Getter.GetAmazon (album, false) == null) {
+					cover_db.covers.Remove (key);
+					to_unmark.Add (key);
+				}
+			}
+		}
+
+		// Internal Classes :: PrefetchThread
+		/// <summary>
+		///	Decodes covers into the cache ahead of time.
+		/// </summary>
+		private class PrefetchThread
+		{
+			// Objects
+			private CoverDatabase cover_db;
+			private Queue queue = new Queue ();
+
+			// Constructor
+			public PrefetchThread (CoverDatabase cover_db)
+			{
+				this.cover_db = cover_db;
+
+				Thread thread = new Thread (new ThreadStart (ThreadFunc));
+				thread.IsBackground = true;
+				thread.Priority = ThreadPriority.BelowNormal;
+				thread.Start ();
+			}
+
+			// Methods
+			// Methods :: Public
+			// Methods :: Public :: Add
+			//	Only the latest keys matter, the view has moved
+			//	on from the earlier ones.
+			public void Add (string [] keys)
+			{
+				lock (queue) {
+					queue.Clear ();
+
+					foreach (string key in keys)
+						queue.Enqueue (key);
+
+					Monitor.Pulse (queue);
+				}
+			}
+
+			// Delegate Functions
+			// Delegate Functions :: ThreadFunc
+			private void ThreadFunc ()
+			{
+				while (true) {
+					string key;
+
+					lock (queue) {
+						while (queue.Count == 0)
+							Monitor.Wait (queue);
+
+						key = (string) queue.Dequeue ();
 					}
-					
-					LoadedCover lc = new LoadedCover (item, pixbuf);
-					queue.Enqueue (lc);
+
+					cover_db.LoadCover (key, true);
 				}
 			}
 		}
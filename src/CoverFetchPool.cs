@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+using System.Net;
+using System.Threading;
+
+namespace Muine
+{
+	/// <summary>
+	///	A fixed set of threads which download covers.
+	/// </summary>
+	/// <remarks>
+	///	Jobs are run in the order they were added, but no more than
+	///	a few at a time per host. When a job fails with a
+	///	<see cref="WebException" />, it is tried again later, and the
+	///	host is left alone for a while; the wait doubles with every
+	///	failure in a row, with some jitter so retries don't line up.
+	///	Hosts which limit the request rate can get a lower limit,
+	///	and a minimum interval between job starts, with
+	///	<see cref="SetHostLimits" />.
+	///
+	///	Workers sleep until a job is added, a host frees up, or a
+	///	wait runs out.
+	/// </remarks>
+	public class CoverFetchPool
+	{
+		// GConf
+		private const string GConfKeyThreads = "/apps/muine/cover_fetch_threads";
+		private const int GConfDefaultThreads = 4;
+
+		private const string GConfKeyPerHost = "/apps/muine/cover_fetch_per_host";
+		private const int GConfDefaultPerHost = 2;
+
+		// Constants
+		// Constants :: Backoff
+		//	Seconds to wait after the first failure, and at most
+		private const double BackoffBase =   5;
+		private const double BackoffMax  = 600;
+
+		// Objects
+		private ArrayList pending = new ArrayList ();
+
+		//	Host => HostState
+		private Hashtable hosts = new Hashtable ();
+
+		private Random random = new Random ();
+
+		// Variables
+		private int per_host;
+
+		// Constructor
+		public CoverFetchPool ()
+		{
+			int n_threads = (int) Config.Get (GConfKeyThreads,
+				GConfDefaultThreads);
+
+			per_host = (int) Config.Get (GConfKeyPerHost,
+				GConfDefaultPerHost);
+
+			per_host = Math.Max (per_host, 1);
+
+			// Connections are kept alive, allow one per worker
+			if (ServicePointManager.DefaultConnectionLimit < per_host)
+				ServicePointManager.DefaultConnectionLimit = per_host;
+
+			for (int i = 0; i < Math.Max (n_threads, 1); i ++) {
+				Thread thread = new Thread (new ThreadStart (WorkerFunc));
+				thread.IsBackground = true;
+				thread.Priority = ThreadPriority.BelowNormal;
+				thread.Start ();
+			}
+		}
+
+		// Properties
+		// Properties :: Count (get;)
+		/// <summary>
+		///	The number of jobs waiting, not counting those which
+		///	are running.
+		/// </summary>
+		public int Count {
+			get { lock (this) return pending.Count; }
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: SetHostLimits
+		/// <summary>
+		///	Run at most <paramref name="max_active" /> jobs for
+		///	<paramref name="host" /> at a time, and start them at
+		///	least <paramref name="min_interval" /> seconds apart.
+		/// </summary>
+		public void SetHostLimits (string host, int max_active, double min_interval)
+		{
+			lock (this) {
+				HostState state = GetHost (host);
+
+				state.MaxActive   = Math.Max (max_active, 1);
+				state.MinInterval = TimeSpan.FromSeconds (min_interval);
+
+				Monitor.PulseAll (this);
+			}
+		}
+
+		// Methods :: Public :: Add
+		public void Add (Job job)
+		{
+			lock (this) {
+				pending.Add (job);
+
+				Monitor.PulseAll (this);
+			}
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: GetHost
+		private HostState GetHost (string host)
+		{
+			HostState state = (HostState) hosts [host];
+
+			if (state == null) {
+				state = new HostState (per_host);
+				hosts [host] = state;
+			}
+
+			return state;
+		}
+
+		// Methods :: Private :: Take
+		//	Waits for a job whose host is free. Call with the lock
+		//	held.
+		private Job Take ()
+		{
+			while (true) {
+				DateTime now = DateTime.Now;
+				DateTime wake = DateTime.MaxValue;
+
+				for (int i = 0; i < pending.Count; i ++) {
+					Job job = (Job) pending [i];
+					HostState host = GetHost (job.Host);
+
+					// Pulsed when one of its jobs finishes
+					if (host.Active >= host.MaxActive)
+						continue;
+
+					DateTime start_at = host.RetryAt;
+					if (host.LastStart + host.MinInterval > start_at)
+						start_at = host.LastStart + host.MinInterval;
+
+					if (start_at > now) {
+						if (start_at < wake)
+							wake = start_at;
+
+						continue;
+					}
+
+					pending.RemoveAt (i);
+					host.Active ++;
+					host.LastStart = now;
+
+					return job;
+				}
+
+				if (wake == DateTime.MaxValue)
+					Monitor.Wait (this);
+				else
+					Monitor.Wait (this, wake - now);
+			}
+		}
+
+		// Methods :: Private :: Finish
+		//	Call with the lock held.
+		private void Finish (Job job, bool failed)
+		{
+			HostState host = GetHost (job.Host);
+			host.Active --;
+
+			if (failed) {
+				host.Failures ++;
+
+				double delay = BackoffBase * Math.Pow (2, host.Failures - 1);
+				delay = Math.Min (delay, BackoffMax);
+
+				// 50% to 150%
+				delay *= 0.5 + random.NextDouble ();
+
+				DateTime retry_at = DateTime.Now.AddSeconds (delay);
+				if (retry_at > host.RetryAt)
+					host.RetryAt = retry_at;
+
+				pending.Add (job);
+
+			} else {
+				host.Failures = 0;
+			}
+
+			Monitor.PulseAll (this);
+		}
+
+		// Delegate Functions
+		// Delegate Functions :: WorkerFunc
+		private void WorkerFunc ()
+		{
+			while (true) {
+				Job job;
+
+				lock (this)
+					job = Take ();
+
+				bool failed = false;
+
+				try {
+					job.Run ();
+
+				} catch (WebException) {
+					// Temporary web problem (Timeout etc.) - re-queue
+					failed = true;
+
+				} catch (Exception) {
+				}
+
+				lock (this)
+					Finish (job, failed);
+			}
+		}
+
+		// Internal Classes
+		// Internal Classes :: Job
+		public abstract class Job
+		{
+			// Properties
+			// Properties :: Host (get;)
+			/// <summary>
+			///	The host the job downloads from, for the
+			///	connection limit and backoff.
+			/// </summary>
+			public abstract string Host {
+				get;
+			}
+
+			// Methods
+			// Methods :: Run
+			/// <summary>
+			///	Fetch the cover. Called from a worker thread.
+			/// </summary>
+			/// <exception cref="WebException">
+			///	Thrown to have the job run again later.
+			/// </exception>
+			public abstract void Run ();
+		}
+
+		// Internal Classes :: HostState
+		private class HostState
+		{
+			public int      Active      = 0;
+			public int      Failures    = 0;
+			public DateTime RetryAt     = DateTime.MinValue;
+			public DateTime LastStart   = DateTime.MinValue;
+			public int      MaxActive;
+			public TimeSpan MinInterval = TimeSpan.Zero;
+
+			// Constructor
+			public HostState (int max_active)
+			{
+				MaxActive = max_active;
+			}
+		}
+	}
+}
@@ -20,6 +20,7 @@
 using System;
 using System.Web;
 using System.Net;
+using System.Text;
 using System.Text.RegularExpressions;
 using System.IO;
 using System.Threading;
@@ -43,13 +44,31 @@ namespace Muine
 		private const string GConfKeyAmazonDevTag     = "/apps/muine/amazon_dev_tag";
 		private	const string GConfDefaultAmazonDevTag = "amazondevtag";
 
+		// GConf :: ResponseCacheSize
+		private const string GConfKeyResponseCacheSize     = "/apps/muine/cover_response_cache_size";
+		private const int    GConfDefaultResponseCacheSize = 32; // MB
+
+		// Constants
+		// Constants :: TargetSize
+		//	The size covers are scaled to; 1px border, so -2
+		public const int TargetSize = CoverDatabase.CoverSize - 2;
+
+		// Constants :: AmazonHost
+		//	Amazon and MusicBrainz allow one request a second,
+		//	so lookups are done one at a time, a second apart
+		private const string AmazonHost = "amazon.com";
+		private const double AmazonInterval = 1.0; // seconds
+
 		// Delegates
 		public delegate void GotCoverDelegate (Pixbuf pixbuf);
 
 		// Objects
 		private CoverDatabase db;
 		private GnomeProxy proxy;
-		private GetAmazonThread amazon_thread;
+		private CoverFetchPool pool;
+		private CoverLookupDatabase lookups;
+		private ResponseCache responses;
+		private FolderImageCache folders;
 
 		// Variables
 		private string amazon_locale;
@@ -58,14 +77,15 @@ namespace Muine
 		private bool amazon_dev_tag_missing = false;
 
 		// Variables :: Cover Filenames
-		//	TODO: Maybe make checking these case-insensitve instead
-		//	and split possible extensions from possible filenames.
+		//	Best first, matched regardless of case.
+		//	TODO: Maybe split possible extensions from possible
+		//	filenames.
 		private string [] cover_filenames = {
-			"cover.jpg" , "Cover.jpg" ,
-			"cover.jpeg", "Cover.jpeg",
-			"cover.png" , "Cover.png" ,
-			"cover.gif" , "Cover.gif" ,
-			"folder.jpg", "Folder.jpg"
+			"cover.jpg" ,
+			"cover.jpeg",
+			"cover.png" ,
+			"cover.gif" ,
+			"folder.jpg"
 		};
 
 		// Constructor
@@ -94,11 +114,35 @@ namespace Muine
 
 			proxy = new GnomeProxy ();
 
-			amazon_thread = new GetAmazonThread (this);
+			pool = new CoverFetchPool ();
+			pool.SetHostLimits (AmazonHost, 1, AmazonInterval);
+
+			lookups = new CoverLookupDatabase (1);
+
+			int responses_size = (int) Config.Get (GConfKeyResponseCacheSize,
+				GConfDefaultResponseCacheSize);
+
+			responses = new ResponseCache (FileUtils.CoverResponsesDirectory,
+				(long) responses_size * 1024 * 1024);
+
+			folders = new FolderImageCache (cover_filenames,
+				new FolderImageCache.LoadFunction (LoadFolderImage));
 		}
 
 		// Methods
 		// Methods :: Public
+		// Methods :: Public :: WriteDebugLog
+		/// <summary>
+		///	Log how many online lookups and downloads were saved
+		///	this session, with <see cref="DebugLog" />.
+		/// </summary>
+		public void WriteDebugLog ()
+		{
+			DebugLog.Write ("covers: {0} lookups skipped as recent, " +
+				"{1} answered from the cache, {2} fetched",
+				lookups.NSaved, responses.NHits, responses.NMisses);
+		}
+
 		// Methods :: Public :: GetLocal
 		/// <summary>
 		///	Set the cover to a local file.
@@ -121,7 +165,7 @@ namespace Muine
 		/// </exception>
 		public Pixbuf GetLocal (string key, string file)
 		{
-			Pixbuf pix = new Pixbuf (file);
+			Pixbuf pix = PixbufUtils.LoadAtSize (file, TargetSize);
 			pix = AddBorder (pix);
 			db.SetCover (key, pix);
 			return pix;
@@ -158,7 +202,9 @@ namespace Muine
 		/// </summary>
 		/// <remarks>
 		///	Image is scaled and placed on a background with
-		///	<see cref="AddBorder" />.
+		///	<see cref="AddBorder" />. The result is kept in a
+		///	<see cref="FolderImageCache" />, so the other songs in
+		///	the folder get the same image without searching again.
 		/// </remarks>
 		/// <param name="key">
 		///	Album key.
@@ -171,26 +217,13 @@ namespace Muine
 		/// </returns>
 		public Pixbuf GetFolderImage (string key, string folder)
 		{
-			foreach (string fn in cover_filenames) {
-				FileInfo cover = new FileInfo (System.IO.Path.Combine (folder, fn));
-				
-				if (!cover.Exists)
-					continue;
-
-				Pixbuf pix;
-
-				try {
-					pix = new Pixbuf (cover.FullName);
-				} catch {
-					continue;
-				}
+			Pixbuf pix = folders.Get (folder);
 
-				pix = AddBorder (pix);
-				db.SetCover (key, pix);
-				return pix;
-			}
+			if (pix == null)
+				return null;
 
-			return null;
+			db.SetCover (key, pix);
+			return pix;
 		}
 
 		// Methods :: Public :: GetWeb
@@ -199,8 +232,8 @@ namespace Muine
 		/// </summary>
 		/// <remarks>
 		///	Immediately returns a temporary cover.
-		///	The actual downloading occurs in
-		///	<see cref="GetWebThread" />.
+		///	The actual downloading occurs in a
+		///	<see cref="CoverFetchPool" />.
 		/// </remarks>
 		/// <param name="key">
 		///	Album key.
@@ -217,8 +250,8 @@ namespace Muine
 		public Pixbuf GetWeb
 		  (string key, string url, GotCoverDelegate done_func)
 		{
-			db.RemoveCover (key);
-			new GetWebThread (this, key, url, done_func);
+			db.MarkAsDownloading (key);
+			pool.Add (new WebJob (this, key, url, done_func));
 			return db.DownloadingPixbuf;
 		}
 
@@ -229,14 +262,15 @@ namespace Muine
 		/// </summary>
 		/// <remarks>
 		///	Immediately returns a temporary cover.
-		///	The actual downloading occurs in
-		///	<see cref="GetAmazonThread" />.
+		///	The actual downloading occurs in a
+		///	<see cref="CoverFetchPool" />.
 		/// </remarks>
 		/// <param name="album">
 		///	An <see cref="Album" />.
 		/// </param>
 		/// <returns>
-		///	A <see cref="Gdk.Pixbuf" /> of the temporary cover.
+		///	A <see cref="Gdk.Pixbuf" /> of the temporary cover, or
+		///	null if it isn't looked up.
 		/// </returns>
 		public Pixbuf GetAmazon (Album album)
 		{
@@ -250,8 +284,8 @@ namespace Muine
 		/// </summary>
 		/// <remarks>
 		///	Immediately returns a temporary cover.
-		///	The actual downloading occurs in
-		///	<see cref="GetAmazonThread" />.
+		///	The actual downloading occurs in a
+		///	<see cref="CoverFetchPool" />.
 		/// </remarks>
 		/// <param name="album">
 		///	An <see cref="Album" />.
@@ -263,25 +297,58 @@ namespace Muine
 		///	it should be 'false'.
 		/// </parm>
 		/// <returns>
-		///	A <see cref="Gdk.Pixbuf" /> of the temporary cover.
+		///	A <see cref="Gdk.Pixbuf" /> of the temporary cover, or
+		///	null if the album was looked up recently and isn't
+		///	looked up again.
 		/// </returns>
 		public Pixbuf GetAmazon (Album album, bool mark)
 		{
+			if (lookups.IsFresh (album.Key))
+				return null;
+
 			if (mark)
 				db.MarkAsBeingChecked (album.Key);
 
-			amazon_thread.Queue.Enqueue (album);
+			pool.Add (new AmazonJob (this, album));
 
 			return db.DownloadingPixbuf;
 		}
 
+		// Methods :: Public :: RetryMisses
+		/// <summary>
+		///	Look up the covers of all albums without one again,
+		///	including those looked up recently.
+		/// </summary>
+		public void RetryMisses ()
+		{
+			lookups.ClearMisses ();
+
+			// Imports add and remove albums meanwhile
+			Album [] albums;
+			lock (Global.DB) {
+				albums = new Album [Global.DB.Albums.Count];
+				Global.DB.Albums.Values.CopyTo (albums, 0);
+			}
+
+			foreach (Album album in albums) {
+				string key = album.Key;
+
+				// Has one, or is being looked for
+				if (db.HasCover (key) || db.GetCover (key) != null)
+					continue;
+
+				GetAmazon (album);
+				album.EmitCoverChanged ();
+			}
+		}
+
 		// Methods :: Public :: DownloadFromAmazon
 		//	TODO: Refactor this
 		/// <summary>
 		///	Search for the album cover on Amazon.
 		/// </summary>
 		/// <remarks>
-		///	This should only be called from <see cref="GetAmazonThread" />.
+		///	This should only be called from <see cref="AmazonJob" />.
 		///	Normally, <see cref="GetAmazon" /> should be used instead.
 		/// </remarks>
 		/// <param name="album">
@@ -303,7 +370,7 @@ namespace Muine
 		///	Get the cover URL from amazon with the help of libmusicbrainz
 		/// </summary>
 		/// <remarks>
-		///	This should only be called from <see cref="GetWebThread" />
+		///	This should only be called from <see cref="WebJob" />
 		/// 	and <see cref="DownloadFromAmazon" />. Normally, 
 		///	<see cref="GetWeb" /> should be used instead.
 		/// </remarks>
@@ -363,50 +430,18 @@ namespace Muine
 				string sane_artist_name_regex = @"^the\s+";
 				sane_artist_name = Regex.Replace (sane_artist_name, sane_artist_name_regex, String.Empty);
 				
-				MusicBrainz c = new MusicBrainz ();
-				
-				// set the depth of the query
-				//   (see http://wiki.musicbrainz.org/ClientHOWTO)
-				c.SetDepth(4);
-
-				string [] album_name = new string [] { sane_album_title };
-
-				bool match =
-				  c.Query (MusicBrainz.MBQ_FindAlbumByName, album_name);
+				string mb_key = String.Format ("musicbrainz\t{0}\t{1}",
+					sane_album_title, sane_artist_name);
 
-				if (match) {
-					int num_albums =
-					  c.GetResultInt (MusicBrainz.MBE_GetNumAlbums);
-					
-					string fetched_artist_name;
-					for (int i = 1; i <= num_albums; i++) {
-						c.Select (MusicBrainz.MBS_SelectAlbum, i);
-
-						// gets the artist from the first track of the album
-						c.GetResultData
-						  (MusicBrainz.MBE_AlbumGetArtistName, 1,
-						   out fetched_artist_name);
+				asin = responses.GetString (mb_key);
 
-						// Remove "The " here as well
-						if (fetched_artist_name != null) {
-							string tmp = fetched_artist_name.ToLower ();
-							string fetched_artist_name_regex = @"^the\s+";
-							fetched_artist_name = Regex.Replace (tmp, fetched_artist_name_regex, String.Empty);
-
-						} else {
-							fetched_artist_name = String.Empty;
-						}
-
-						if (fetched_artist_name == sane_artist_name) {
-							c.GetResultData
-							  (MusicBrainz.MBE_AlbumGetAmazonAsin, out asin);
-
-							break;
-						}
+				if (asin == null) {
+					asin = QueryAsin (sane_album_title, sane_artist_name);
 
-						// go back one level so we can select the next album
-						c.Select(MusicBrainz.MBS_Back); 
-					}
+					// Only answers are kept, a miss may be
+					// filled in later
+					if (asin != null)
+						responses.PutString (mb_key, asin);
 				}
 
 				if (asin == null) {
@@ -426,13 +461,69 @@ namespace Muine
 			return pix;
 		}
 		
+		// Methods :: Private :: QueryAsin
+		//	Asks MusicBrainz for the ASIN of the album by the artist.
+		//	Returns null if there's none.
+		private string QueryAsin (string sane_album_title,
+					  string sane_artist_name)
+		{
+			MusicBrainz c = new MusicBrainz ();
+			
+			// set the depth of the query
+			//   (see http://wiki.musicbrainz.org/ClientHOWTO)
+			c.SetDepth(4);
+
+			string asin = null;
+			string [] album_name = new string [] { sane_album_title };
+
+			bool match =
+			  c.Query (MusicBrainz.MBQ_FindAlbumByName, album_name);
+
+			if (match) {
+				int num_albums =
+				  c.GetResultInt (MusicBrainz.MBE_GetNumAlbums);
+				
+				string fetched_artist_name;
+				for (int i = 1; i <= num_albums; i++) {
+					c.Select (MusicBrainz.MBS_SelectAlbum, i);
+
+					// gets the artist from the first track of the album
+					c.GetResultData
+					  (MusicBrainz.MBE_AlbumGetArtistName, 1,
+					   out fetched_artist_name);
+
+					// Remove "The " here as well
+					if (fetched_artist_name != null) {
+						string tmp = fetched_artist_name.ToLower ();
+						string fetched_artist_name_regex = @"^the\s+";
+						fetched_artist_name = Regex.Replace (tmp, fetched_artist_name_regex, String.Empty);
+
+					} else {
+						fetched_artist_name = String.Empty;
+					}
+
+					if (fetched_artist_name == sane_artist_name) {
+						c.GetResultData
+						  (MusicBrainz.MBE_AlbumGetAmazonAsin, out asin);
+
+						break;
+					}
+
+					// go back one level so we can select the next album
+					c.Select(MusicBrainz.MBS_Back); 
+				}
+			}
+
+			return asin;
+		}
+
 		// Methods :: Private :: DownloadFromAmazonViaAPI
 		/// <summary>
 		///   Get the cover URL from amazon usig the Amazon API (required
 		///   valid dev tag in GConf)
 		/// </summary>
 		/// <remarks>
-		///   This should only be called from <see cref="GetWebThread" />
+		///   This should only be called from <see cref="WebJob" />
 		///   and <see cref="DownloadFromAmazon" />. Normally, 
 		///	<see cref="GetWeb" /> should be used instead.
 		/// </remarks>
@@ -525,22 +616,15 @@ namespace Muine
 			while (current_page <= total_pages && current_page <= max_pages) {
 				asearch.page = Convert.ToString (current_page);
 
-				Amazon.ProductInfo pi;
-				
-				// Amazon API requires this
-				Thread.Sleep (1000);
-			
-				// Web service calls timeout after 30 seconds
-				search_service.Timeout = 30000;
-				if (proxy.Use)
-					search_service.Proxy = proxy.Proxy;
-				
+				string [] product_names;
+				string [] image_urls;
+
 				// This may throw an exception, we catch it in the calling
 				//   function
-				pi = search_service.ArtistSearchRequest (asearch);
+				total_pages = SearchAmazon (search_service, asearch,
+					out product_names, out image_urls);
 
-				int num_results = pi.Details.Length;
-				total_pages = Convert.ToInt32 (pi.TotalPages);
+				int num_results = product_names.Length;
 
 				// Work out how many matches are on this page
 				if (num_results < 1)
@@ -549,10 +633,8 @@ namespace Muine
 				for (int i = 0; i < num_results; i++) {
 					// Ignore bracketed text on the result from Amazon
 					
-					Amazon.Details details = pi.Details [i];
-
 					string sane_product_name =
-					  SanitizeString (details.ProductName);
+					  SanitizeString (product_names [i]);
 
 					// Compare the two strings statistically
 					string [] product_name_array =
@@ -574,7 +656,7 @@ namespace Muine
 					if (match_percent < 0.6)
 						continue;
 
-					string url = pi.Details [i].ImageUrlMedium;
+					string url = image_urls [i];
 
 					if (url == null || url.Length == 0)
 						continue;
@@ -629,12 +711,65 @@ namespace Muine
 			return best_match;
 		}
 
+		// Methods :: Private :: SearchAmazon
+		//	One page of Amazon search results, from the response
+		//	cache if it's there. Returns the number of pages.
+		private int SearchAmazon (Amazon.AmazonSearchService search_service,
+					  Amazon.ArtistRequest asearch,
+					  out string [] product_names,
+					  out string [] image_urls)
+		{
+			string key = String.Format ("amazon\t{0}\t{1}\t{2}\t{3}",
+				asearch.locale, asearch.artist, asearch.keywords,
+				asearch.page);
+
+			string cached = responses.GetString (key);
+
+			AmazonSearchPage page = null;
+			if (cached != null)
+				page = AmazonSearchPage.Parse (cached);
+
+			if (page == null) {
+				// Amazon API requires this
+				Thread.Sleep (1000);
+		
+				// Web service calls timeout after 30 seconds
+				search_service.Timeout = 30000;
+				if (proxy.Use)
+					search_service.Proxy = proxy.Proxy;
+			
+				Amazon.ProductInfo pi = search_service.ArtistSearchRequest (asearch);
+
+				int n = pi.Details.Length;
+
+				string [] names = new string [n];
+				string [] urls  = new string [n];
+
+				for (int i = 0; i < n; i ++) {
+					names [i] = pi.Details [i].ProductName;
+					urls  [i] = pi.Details [i].ImageUrlMedium;
+				}
+
+				page = new AmazonSearchPage (Convert.ToInt32 (pi.TotalPages),
+					names, urls);
+
+				// An empty page may be filled in later
+				if (n > 0)
+					responses.PutString (key, page.ToString ());
+			}
+
+			product_names = page.ProductNames;
+			image_urls    = page.ImageUrls;
+
+			return page.TotalPages;
+		}
+
 		// Methods :: Public :: Download
 		/// <summary>
 		///	Get the cover from a URL.
 		/// </summary>
 		/// <remarks>
-		///	This should only be called from <see cref="GetWebThread" />
+		///	This should only be called from <see cref="WebJob" />
 		/// 	and <see cref="DownloadFromAmazon" />. Normally, 
 		///	<see cref="GetWeb" /> should be used instead.
 		/// </remarks>
@@ -652,12 +787,49 @@ namespace Muine
 		/// </exception>
 		public Pixbuf Download (string url)
 		{
-			Pixbuf cover;
+			Pixbuf cover = null;
 
+			byte [] data = responses.Get (url);
+
+			if (data != null) {
+				try {
+					cover = PixbufUtils.LoadAtSize (data, TargetSize);
+				} catch (GLib.GException) {
+				}
+
+				if (cover == null)
+					responses.Remove (url);
+			}
+
+			if (cover == null) {
+				data = Fetch (url);
+
+				cover = PixbufUtils.LoadAtSize (data, TargetSize);
+				if (cover == null)
+					return null;
+
+				// Only now we know it's an image, and not an
+				// error page or a truncated download
+				responses.Put (url, data);
+			}
+
+			// Trap Amazon 1x1 images
+			if (cover.Height == 1 && cover.Width == 1)
+				return null;
+
+			return cover;
+		}
+
+		// Methods :: Private :: Fetch
+		/// <exception cref="WebException">
+		///	Thrown if an error occurred while downloading.
+		/// </exception>
+		private byte [] Fetch (string url)
+		{
 			// read the cover image
 			HttpWebRequest req = (HttpWebRequest) WebRequest.Create (url);
 			req.UserAgent = "Muine";
-			req.KeepAlive = false;
+			req.KeepAlive = true;
 			req.Timeout = 30000; // Timeout after 30 seconds
 			if (proxy.Use)
 				req.Proxy = proxy.Proxy;
@@ -667,16 +839,21 @@ namespace Muine
 			resp = req.GetResponse ();
 
 			Stream s = resp.GetResponseStream ();
+			MemoryStream data = new MemoryStream ();
 		
-			cover = new Pixbuf (s);
+			// Always close, or the kept alive connection is lost
+			try {
+				byte [] buf = new byte [16384];
+				int n;
 
-			resp.Close ();
+				while ((n = s.Read (buf, 0, buf.Length)) > 0)
+					data.Write (buf, 0, n);
 
-			// Trap Amazon 1x1 images
-			if (cover.Height == 1 && cover.Width == 1)
-				return null;
+			} finally {
+				resp.Close ();
+			}
 
-			return cover;
+			return data.ToArray ();
 		}
 
 		// Methods :: Public :: AddBorder
@@ -692,8 +869,7 @@ namespace Muine
 		public Pixbuf AddBorder (Pixbuf cover)
 		{
 
-			// 1px border, so -2
-			int target_size = CoverDatabase.CoverSize - 2;
+			int target_size = TargetSize;
 
 			// scale the cover image if necessary
 			if (cover.Height > target_size || cover.Width > target_size) {
@@ -721,6 +897,13 @@ namespace Muine
 		}
 
 		// Methods :: Private
+		// Methods :: Private :: LoadFolderImage
+		private Pixbuf LoadFolderImage (string file)
+		{
+			Pixbuf pix = PixbufUtils.LoadAtSize (file, TargetSize);
+			return AddBorder (pix);
+		}
+
 		// Methods :: Private :: SanitizeString
 		//	TODO: We should probably also trim the string at the 
 		//	end.
@@ -789,9 +972,8 @@ namespace Muine
 		}
 
 		// Internal Classes
-		// Internal Classes :: GetWebThread
-		//   FIXME: Split off? This is big.
-		private class GetWebThread
+		// Internal Classes :: WebJob
+		private class WebJob : CoverFetchPool.Job
 		{
 			// Delegates
 			private GotCoverDelegate done_func;
@@ -803,27 +985,10 @@ namespace Muine
 			// Variables
 			private string key;
 			private string url;
+			private string host;
 
 			// Constructor
-			/// <summary>
-			///	Create a new <see cref="GetWebThread" />.
-			/// </summary>
-			/// <param name="getter">
-			///	A <see cref="CoverGetter" />.
-			/// </param>
-			/// <param name="key">
-			/// 	The album key.
-			/// </param>
-			/// <param name="url">
-			///	The URL from which to download the cover.
-			/// </param>
-			/// <param name="done_func">
-			///	The delegate to call when the cover is done downloading.
-			/// </param>
-			/// <returns>
-			///	A <see cref="Gdk.Pixbuf" /> of the modified cover.
-			/// </returns>
-			public GetWebThread (CoverGetter getter, string key, string url,
+			public WebJob (CoverGetter getter, string key, string url,
 			  GotCoverDelegate done_func)
 			{
 				this.getter = getter;
@@ -831,229 +996,138 @@ namespace Muine
 				this.url = url;
 				this.done_func = done_func;
 
-				Thread thread = new Thread (new ThreadStart (ThreadFunc));
-				thread.IsBackground = true;
-				thread.Priority = ThreadPriority.BelowNormal;
-				thread.Start ();
+				try {
+					host = new Uri (url).Host;
+				} catch {
+					host = url;
+				}
 			}
 
-			// Methods
-			// Methods :: Private
-			// Methods :: Private :: SignalIdle
-			/// <summary>
-			///	Calls the <see cref="GotCoverDelegate" />.
-			/// </summary>
-			/// <remarks>
-			///	<para>
-			///	This is the method called when idling. It calls the 
-			///	<see cref="GotCoverDelegate" /> because if we're
-			///	idling, we must be done downloading.
-			///	</para>
-			///
-			///	<para>
-			/// 	This is not entirely safe, as the user can in theory
-			/// 	have changed the cover image between the thread and
-			/// 	this idle. However, chances are very, very slim and
-			/// 	things won't explode if it happens.
-			///	</para>
-			/// </remarks>
-			/// <returns>
-			///	False, we only want to do this once.
-			/// </returns>
-			private bool SignalIdle ()
-			{
-				done_func (pixbuf);
-
-				return false;
-			}			
+			// Properties
+			// Properties :: Host (get;) (CoverFetchPool.Job)
+			public override string Host {
+				get { return host; }
+			}
 
-			// Delegate Functions
-			// Delegate Functions :: ThreadFunc
-			/// <summary>
-			///	Downloads the cover and sets it in the database.
-			/// </summary>
-			/// <remarks>
-			///	This is the main method of the thread.
-			/// </remarks>
-			private void ThreadFunc ()
+			// Methods
+			// Methods :: Public
+			// Methods :: Public :: Run (CoverFetchPool.Job)
+			//	Tried once; the user can drop the URL again.
+			public override void Run ()
 			{
 				try {
 					pixbuf = getter.Download (url);
 					pixbuf = getter.AddBorder (pixbuf);
 				} catch {
+					pixbuf = null;
 				}
 
 				// Check if cover has been modified while we were downloading
-				if (Global.CoverDB.Covers [key] != null)
+				if (Global.CoverDB.HasCover (key))
 					return;
 
 				if (pixbuf != null)
 					Global.CoverDB.SetCover (key, pixbuf);
+				else
+					Global.CoverDB.UnmarkAsDownloading (key);
 
 				// Also do this if it is null, as we need to remove the
 				// downloading image
 				GLib.IdleHandler idle = new GLib.IdleHandler (SignalIdle);
 				GLib.Idle.Add (idle);
 			}
+
+			// Methods :: Private
+			// Methods :: Private :: SignalIdle
+			private bool SignalIdle ()
+			{
+				done_func (pixbuf);
+
+				return false;
+			}			
 		}
 
-		// Internal Classes :: GetAmazonThread
-		// 	FIXME: Split off? This is big.
-		/// <summary>
-		///	This is used to download covers from Amazon in a threaded
-		///	fashion.
-		/// </summary>
-		/// <remarks>
-		///	To download a cover, simply <see cref="Queue.Enqueue" />
-		/// 	it on the <see cref="Queue" />.
-		/// </remarks>
-		private class GetAmazonThread
+		// Internal Classes :: AmazonJob
+		private class AmazonJob : CoverFetchPool.Job
 		{
 			// Objects
 			private CoverGetter getter;
-			private Queue queue;
-
-			// Internal Classes
-			// Internal Classes :: IdleData
-			// 	FIXME: Internal classes inside internal classes? ick!
-			private class IdleData
-			{
-				// Objects
-				private Album album;
-				private Pixbuf pixbuf;
-
-				// Constructor
-				/// <summary>
-				///	Create a new <see cref="IdleData" /> object.
-				/// </summary>
-				public IdleData (Album album, Pixbuf pixbuf)
-				{
-					this.album = album;
-					this.pixbuf = pixbuf;
-
-					GLib.IdleHandler idle = new GLib.IdleHandler (IdleFunc);
-					GLib.Idle.Add (idle);
-				}
-
-				// Delegate Functions
-				// Delegate Functions :: IdleFunc
-				/// <summary>
-				///	Sets the cover to the currently held
-				///	<see cref="Gdk.Pixbuf" />.
-				/// </summary>
-				/// <remarks>
-				///	<para>
-				///	This is the method called when idling. It is used
-				///	to flush the covers in the queue to the database.
-				///	</para>
-				///
-				///	<para>
-				/// 	This is not entirely safe, as the user can in theory
-				/// 	have changed the cover image between the thread and
-				/// 	this idle. However, chances are very, very slim and
-				/// 	things won't explode if it happens.
-				///	</para>
-				/// </remarks>
-				/// <returns>
-				///	False, we only want to do this once.
-				/// </returns>
-				private bool IdleFunc ()
-				{
-					album.CoverImage = pixbuf;
-		
-					return false;
-				}
-			}
+			private Album album;
 
 			// Constructor
-			/// <summary>
-			///	Create a new <see cref="GetAmazonThread" />.
-			/// </summary>			
-			public GetAmazonThread (CoverGetter getter)
+			public AmazonJob (CoverGetter getter, Album album)
 			{
 				this.getter = getter;
-
-				queue = Queue.Synchronized (new Queue ());
-
-				Thread thread = new Thread (new ThreadStart (ThreadFunc));
-				thread.IsBackground = true;
-				thread.Priority = ThreadPriority.BelowNormal;
-				thread.Start ();
+				this.album = album;
 			}
 
 			// Properties
-			// Properties :: Queue (get;)
-			/// <summary>
-			///	The <see cref="Queue" />, which holds albums to
-			///	download.
-			/// </summary>
-			/// <returns>
-			/// 	A <see cref="Queue" />.
-			/// </returns>
-			public Queue Queue {
-				get { return queue; }
+			// Properties :: Host (get;) (CoverFetchPool.Job)
+			//	MusicBrainz, then Amazon; they're throttled
+			//	together.
+			public override string Host {
+				get { return AmazonHost; }
 			}
 
-			// Delegate Functions
-			// Delegate Functions :: ThreadFunc
-			//	TODO: Refactor
+			// Methods
+			// Methods :: Public
+			// Methods :: Public :: Run (CoverFetchPool.Job)
 			/// <summary>
 			///	Downloads the cover and sets it in the database.
 			/// </summary>
-			/// <remarks>
-			///	<para>
-			///	This is the main method of the thread.
-			///	</para>
-			///
-			///	<para>
-			///	If the cover has trouble downloading, this thread
-			///	sleeps for a minute. In order to not overload the
-			///	server, this thread sleeps for a second between
-			///	downloads. The Amazon API requires that we do this.
-			///	</para>
-			/// </remarks>
-			private void ThreadFunc ()
+			/// <exception cref="WebException">
+			///	Thrown on a temporary web problem, the pool
+			///	tries again later.
+			/// </exception>
+			public override void Run ()
 			{
-				while (true) {
-					while (queue.Count > 0) {
-						Album album = (Album) queue.Dequeue ();
-						Pixbuf pixbuf = null;
-
-						// Download Cover
-						try {
-							pixbuf = getter.DownloadFromAmazon (album);
-
-						} catch (WebException) {
-							// Temporary web problem (Timeout etc.) - re-queue
-							Thread.Sleep (60000); // wait for a minute first
-							queue.Enqueue (album);
-							continue;
+				Pixbuf pixbuf = null;
 
-						} catch (Exception) {
-						}
+				string key = album.Key;
 
-						string key = album.Key;
-						
-						// Check if cover has been modified while we were
-						//   downloading
-						if (Global.CoverDB.Covers [key] != null)
-							continue;
+				// Download Cover
+				try {
+					pixbuf = getter.DownloadFromAmazon (album);
 
-						// Add border and set cover						
-						if (pixbuf == null) {
-							Global.CoverDB.UnmarkAsBeingChecked (key);
+				} catch (WebException) {
+					getter.lookups.Record (key,
+						CoverLookupDatabase.Outcome.Error);
+					throw;
 
-						} else {
-							pixbuf = getter.AddBorder (pixbuf);
-							Global.CoverDB.SetCover (key, pixbuf);
-						}
+				} catch (Exception) {
+				}
 
-						new IdleData (album, pixbuf);
-					}
+				getter.lookups.Record (key, (pixbuf != null) ?
+					CoverLookupDatabase.Outcome.Found :
+					CoverLookupDatabase.Outcome.NotFound);
+				
+				// Check if cover has been modified while we were
+				//   downloading
+				if (Global.CoverDB.HasCover (key))
+					return;
 
-					Thread.Sleep (1000);
+				// Add border and set cover						
+				if (pixbuf == null) {
+					Global.CoverDB.UnmarkAsBeingChecked (key);
+
+				} else {
+					pixbuf = getter.AddBorder (pixbuf);
+					Global.CoverDB.SetCover (key, pixbuf);
 				}
-			}						
+
+				GLib.IdleHandler idle = new GLib.IdleHandler (SignalIdle);
+				GLib.Idle.Add (idle);
+			}
+
+			// Methods :: Private
+			// Methods :: Private :: SignalIdle
+			//	The cover itself is already in the database.
+			private bool SignalIdle ()
+			{
+				album.EmitCoverChanged ();
+
+				return false;
+			}
 		}
 	}
 }
@@ -182,8 +182,10 @@ namespace Muine
 		private void Sync ()
 		{
 			// Image
-			if (song != null && song.CoverImage != null) {
-				image.Pixbuf = song.CoverImage;
+			Gdk.Pixbuf cover = (song != null) ? song.CoverImage : null;
+
+			if (cover != null) {
+				image.Pixbuf = cover;
 
 			} else if (song != null && Global.CoverDB.Loading) {
 				image.Pixbuf = Global.CoverDB.DownloadingPixbuf;
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+
+namespace Muine
+{
+	/// <summary>
+	///	Remembers how the last online cover lookup for each album
+	///	turned out, and when.
+	/// </summary>
+	/// <remarks>
+	///	An album isn't looked up again while its last outcome is
+	///	fresh. How long that is depends on the outcome: a cover
+	///	that wasn't found is unlikely to show up soon, while an
+	///	error may be gone in an hour.
+	/// </remarks>
+	public class CoverLookupDatabase
+	{
+		// GConf
+		//	Hours; 0 means always look again
+		private const string GConfKeyFoundTTL = "/apps/muine/cover_lookup_found_ttl";
+		private const int GConfDefaultFoundTTL = 0;
+
+		private const string GConfKeyNotFoundTTL = "/apps/muine/cover_lookup_not_found_ttl";
+		private const int GConfDefaultNotFoundTTL = 24 * 30;
+
+		private const string GConfKeyErrorTTL = "/apps/muine/cover_lookup_error_ttl";
+		private const int GConfDefaultErrorTTL = 24;
+
+		// Enums
+		// Enums :: Outcome
+		public enum Outcome {
+			Found,
+			NotFound,
+			Error
+		}
+
+		// Objects
+		private Database db;
+
+		//	Album key => Entry
+		private Hashtable entries;
+
+		// Variables
+		private bool loaded = false;
+		private int n_saved = 0;
+
+		// Constructor
+		/// <summary>
+		///	Create a <see cref="CoverLookupDatabase" /> object.
+		/// </summary>
+		/// <param name="version">
+		///	Version of the database to use.
+		/// </param>
+		public CoverLookupDatabase (int version)
+		{
+			db = new Database (FileUtils.CoverLookupsDBFile, version);
+
+			entries = new Hashtable ();
+		}
+
+		// Properties
+		// Properties :: NSaved (get;)
+		/// <summary>
+		///	The number of lookups skipped this session because
+		///	the last outcome was still fresh.
+		/// </summary>
+		public int NSaved {
+			get { lock (this) return n_saved; }
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: IsFresh
+		/// <summary>
+		///	Whether <paramref name="key" /> was looked up recently
+		///	enough not to do it again. Counts as a saved lookup
+		///	if so.
+		/// </summary>
+		public bool IsFresh (string key)
+		{
+			lock (this) {
+				Load ();
+
+				Entry entry = (Entry) entries [key];
+				if (entry == null)
+					return false;
+
+				int ttl = GetTTL (entry.Outcome);
+				if (ttl <= 0)
+					return false;
+
+				DateTime expires = new DateTime (entry.Time).AddHours (ttl);
+				if (DateTime.UtcNow >= expires)
+					return false;
+
+				n_saved ++;
+
+				return true;
+			}
+		}
+
+		// Methods :: Public :: Record
+		public void Record (string key, Outcome outcome)
+		{
+			lock (this) {
+				Load ();
+
+				Entry entry = new Entry (outcome, DateTime.UtcNow.Ticks);
+				entries [key] = entry;
+
+				int data_size;
+				IntPtr data = entry.Pack (out data_size);
+				db.Store (key, data, data_size, true);
+			}
+		}
+
+		// Methods :: Public :: ClearMisses
+		/// <summary>
+		///	Forget the lookups which didn't find a cover, so
+		///	they're done again.
+		/// </summary>
+		public void ClearMisses ()
+		{
+			lock (this) {
+				Load ();
+
+				ArrayList misses = new ArrayList ();
+
+				foreach (DictionaryEntry de in entries) {
+					Entry entry = (Entry) de.Value;
+
+					if (entry.Outcome != Outcome.Found)
+						misses.Add (de.Key);
+				}
+
+				foreach (string key in misses) {
+					entries.Remove (key);
+					db.Delete (key);
+				}
+			}
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: Load
+		//	Call with the lock held.
+		private void Load ()
+		{
+			if (loaded)
+				return;
+
+			db.Load (new Database.DecodeFunctionDelegate (DecodeFunction));
+			loaded = true;
+		}
+
+		// Methods :: Private :: GetTTL
+		private int GetTTL (Outcome outcome)
+		{
+			switch (outcome) {
+			case Outcome.Found:
+				return (int) Config.Get (GConfKeyFoundTTL,
+					GConfDefaultFoundTTL);
+
+			case Outcome.NotFound:
+				return (int) Config.Get (GConfKeyNotFoundTTL,
+					GConfDefaultNotFoundTTL);
+
+			default:
+				return (int) Config.Get (GConfKeyErrorTTL,
+					GConfDefaultErrorTTL);
+			}
+		}
+
+		// Delegate Functions
+		// Delegate Functions :: DecodeFunction
+		private void DecodeFunction (string key, IntPtr data)
+		{
+			entries [key] = new Entry (data);
+		}
+
+		// Internal Classes
+		// Internal Classes :: Entry
+		private class Entry
+		{
+			public Outcome Outcome;
+			public long    Time; // UTC ticks
+
+			// Constructor
+			public Entry (Outcome outcome, long time)
+			{
+				Outcome = outcome;
+				Time    = time;
+			}
+
+			public Entry (IntPtr data)
+			{
+				IntPtr p = data;
+
+				int outcome;
+				p = Database.UnpackInt  (p, out outcome);
+				p = Database.UnpackLong (p, out Time   );
+
+				Outcome = (Outcome) outcome;
+			}
+
+			// Methods
+			// Methods :: Public
+			// Methods :: Public :: Pack
+			public IntPtr Pack (out int length)
+			{
+				IntPtr p;
+
+				p = Database.PackStart ();
+
+				Database.PackInt  (p, (int) Outcome);
+				Database.PackLong (p, Time         );
+
+				return Database.PackEnd (p, out length);
+			}
+		}
+	}
+}
@@ -74,6 +74,10 @@ namespace Muine
 		///	Pack a <see cref="Gdk.Pixbuf" /> so it can be stored in
 		/// 	the database.
 		/// </summary>
+		/// <remarks>
+		///	The pixbuf is packed as PNG, or as RLE compressed
+		///	GdkPixdata if that fails.
+		/// </remarks>
 		/// <param name="p">
 		///	An <see cref="IntPtr" /> to where the value should be stored.
 		/// </param>
@@ -150,6 +154,26 @@ namespace Muine
 			db_pack_int (p, i);
 		}
 		
+		// Static :: Methods :: Pack :: PackLong
+		/// <summary>
+		///	Pack a <see cref="Int64">long</see> so it can be
+		///	stored in the database.
+		/// </summary>
+		/// <remarks>
+		///	Stored as two integers, high half first.
+		/// </remarks>
+		/// <param name="p">
+		///	An <see cref="IntPtr" /> to where the value should be stored.
+		/// </param>
+		/// <param name="l">
+		///	A <see cref="Int64">long</see>.
+		/// </param>
+		public static void PackLong (IntPtr p, long l)
+		{
+			db_pack_int (p, (int) (l >> 32));
+			db_pack_int (p, (int) l);
+		}
+		
 		// Static :: Methods :: Pack :: PackBool
 		[DllImport ("libmuine")]
 		private static extern void db_pack_bool (IntPtr p, bool b);
@@ -254,6 +278,31 @@ namespace Muine
 			return db_unpack_int (p, out i);
 		}
 
+		// Static :: Methods :: Unpack :: UnpackLong
+		/// <summary>
+		///	Unpack a <see cref="Int64">long</see> from the database.
+		/// </summary>
+		/// <param name="p">
+		///	An <see cref="IntPtr" /> to where the value is stored.
+		/// </param>
+		/// <param name="l">
+		///	Location to store the unpacked value.
+		/// </param>
+		/// <returns>
+		/// An <see cref="IntPtr" /> to where the end of the value is stored.
+		/// </returns>
+		public static IntPtr UnpackLong (IntPtr p, out long l)
+		{
+			int high, low;
+
+			p = db_unpack_int (p, out high);
+			p = db_unpack_int (p, out low );
+
+			l = ((long) high << 32) | (uint) low;
+
+			return p;
+		}
+
 		// Static :: Methods :: Unpack :: UnpackPixbuf
 		//	TODO: Return a Gdk.Pixbuf in the out parameter.
 		[DllImport ("libmuine")]
@@ -279,6 +328,57 @@ namespace Muine
 			return db_unpack_pixbuf (p, out pixbuf);
 		}
 
+		// Static :: Methods :: Unpack :: UnpackPixbufData
+		[DllImport ("libmuine")]
+		private static extern IntPtr db_unpack_pixbuf_data
+		  (IntPtr p, out IntPtr data, out int len);
+
+		/// <summary>
+		///	Copy a packed <see cref="Gdk.Pixbuf" /> out of the
+		///	database, to decode it later with
+		///	<see cref="DecodePixbuf" />.
+		/// </summary>
+		/// <param name="p">
+		///	A <see cref="IntPtr" /> to where the value is stored.
+		/// </param>
+		/// <param name="data">
+		///	Location to store the packed pixbuf.
+		/// </param>
+		/// <returns>
+		///	An <see cref="IntPtr" /> to where the end of the value
+		/// 	is stored.
+		/// </returns>
+		public static IntPtr UnpackPixbufData (IntPtr p, out byte [] data)
+		{
+			IntPtr ptr;
+			int len;
+
+			p = db_unpack_pixbuf_data (p, out ptr, out len);
+
+			data = new byte [len];
+			Marshal.Copy (ptr, data, 0, len);
+
+			return p;
+		}
+
+		// Static :: Methods :: Unpack :: DecodePixbuf
+		[DllImport ("libmuine")]
+		private static extern IntPtr db_pixbuf_from_data
+		  (byte [] data, int len);
+
+		/// <summary>
+		///	Decode a pixbuf copied with
+		///	<see cref="UnpackPixbufData" />.
+		/// </summary>
+		/// <returns>
+		///	An <see cref="IntPtr" /> to the <see cref="Gdk.Pixbuf" />,
+		///	or <see cref="IntPtr.Zero" /> if it can't be decoded.
+		/// </returns>
+		public static IntPtr DecodePixbuf (byte [] data)
+		{
+			return db_pixbuf_from_data (data, data.Length);
+		}
+
 		// Static :: Methods :: Unpack :: UnpackString
 		//	TODO: Merge the second overload into the first one since
 		//	that is the only place that uses it.
@@ -423,6 +523,29 @@ namespace Muine
 			db_foreach (db_ptr, decode_function, IntPtr.Zero);
 		}
 			
+		// Methods :: Public :: Fetch
+		[DllImport ("libmuine")]
+		private static extern bool db_fetch (IntPtr db_ptr, string key,
+						     DecodeFunctionDelegate decode_function,
+						     IntPtr data);
+
+		/// <summary>
+		///	Decode a single record.
+		/// </summary>
+		/// <param name="key">
+		///	The key of the record.
+		/// </param>
+		/// <param name="decode_function">
+		///	The delegate used to decode the record.
+		/// </param>
+		/// <returns>
+		///	False if there is no such record.
+		/// </returns>
+		public bool Fetch (string key, DecodeFunctionDelegate decode_function)
+		{
+			return db_fetch (db_ptr, key, decode_function, IntPtr.Zero);
+		}
+
 		// Methods :: Public :: Store
 		[DllImport ("libmuine")]
 		private static extern void db_store
@@ -482,5 +605,18 @@ namespace Muine
 		{
 			db_delete (db_ptr, key);
 		}
+
+		// Methods :: Public :: Reorganize
+		[DllImport ("libmuine")]
+		private static extern void db_reorganize (IntPtr db_ptr);
+
+		/// <summary>
+		///	Shrink the database file after many records were
+		///	removed or replaced.
+		/// </summary>
+		public void Reorganize ()
+		{
+			db_reorganize (db_ptr);
+		}
 	} 
 }
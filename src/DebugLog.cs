@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+
+namespace Muine
+{
+	/// <summary>
+	///	Timings and counters, written to stderr when MUINE_DEBUG
+	///	is set.
+	/// </summary>
+	public static class DebugLog
+	{
+		// Variables
+		private static bool enabled =
+		  (Environment.GetEnvironmentVariable ("MUINE_DEBUG") != null);
+
+		// Properties
+		// Properties :: Enabled (get;)
+		public static bool Enabled {
+			get { return enabled; }
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Write
+		public static void Write (string format, params object [] args)
+		{
+			if (!enabled)
+				return;
+
+			Console.Error.WriteLine ("muine: " + format, args);
+		}
+	}
+}
@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+
+namespace Muine
+{
+	/// <summary>
+	///	Remembers what the directories below the watched folders
+	///	looked like when they were last read.
+	/// </summary>
+	/// <remarks>
+	///	A directory whose mtime hasn't moved since then still has
+	///	the same entries, so rescans don't need to read it, or stat
+	///	the songs in it.
+	/// </remarks>
+	public class DirectoryDatabase
+	{
+		// Objects
+		private Database db;
+		private Hashtable states;
+
+		// Variables
+		private bool loaded = false;
+
+		// Constructor
+		/// <summary>
+		///	Create a <see cref="DirectoryDatabase" /> object.
+		/// </summary>
+		/// <param name="version">
+		///	Version of the database to use.
+		/// </param>
+		public DirectoryDatabase (int version)
+		{
+			db = new Database (FileUtils.DirectoriesDBFile, version);
+
+			states = new Hashtable ();
+		}
+
+		// Properties
+		// Properties :: Paths (get;)
+		/// <summary>
+		///	The directories we know about.
+		/// </summary>
+		public string [] Paths {
+			get {
+				lock (this) {
+					string [] paths = new string [states.Count];
+					states.Keys.CopyTo (paths, 0);
+					return paths;
+				}
+			}
+		}
+
+		// Indexers
+		/// <summary>
+		///	The last known state of <paramref name="path" />, or
+		///	null if we don't know it.
+		/// </summary>
+		public DirectoryState this [string path] {
+			get { lock (this) return (DirectoryState) states [path]; }
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Load
+		/// <summary>
+		///	Load the database, unless that was done already.
+		/// </summary>
+		public void Load ()
+		{
+			lock (this) {
+				if (loaded)
+					return;
+
+				db.Load (new Database.DecodeFunctionDelegate (DecodeFunction));
+				loaded = true;
+			}
+		}
+
+		// Methods :: Public :: Store
+		public void Store (string path, DirectoryState state)
+		{
+			lock (this) {
+				states [path] = state;
+
+				int data_size;
+				IntPtr data = state.Pack (out data_size);
+				db.Store (path, data, data_size, true);
+			}
+		}
+
+		// Methods :: Public :: Remove
+		public void Remove (string path)
+		{
+			lock (this) {
+				states.Remove (path);
+				db.Delete (path);
+			}
+		}
+
+		// Delegate Functions
+		// Delegate Functions :: DecodeFunction
+		private void DecodeFunction (string key, IntPtr data)
+		{
+			states [key] = new DirectoryState (data);
+		}
+
+		// Internal Classes
+		// Internal Classes :: DirectoryState
+		public class DirectoryState
+		{
+			// Variables
+			private int mtime;
+			private int scan_time;
+			private string id;
+			private int n_entries;
+			private int hash;
+			private string [] subdirs;
+
+			// Constructor
+			/// <summary>
+			///	Create the state of a directory which was just
+			///	read.
+			/// </summary>
+			/// <param name="mtime">
+			///	The mtime of the directory before it was read.
+			/// </param>
+			/// <param name="id">
+			///	Device and inode of the directory.
+			/// </param>
+			/// <param name="entries">
+			///	The entries, as returned by
+			///	<see cref="DirectoryWalker.List" />.
+			/// </param>
+			public DirectoryState (int mtime, string id, string [] entries)
+			{
+				this.mtime = mtime;
+				this.id    = id;
+
+				TimeSpan since_epoch = DateTime.UtcNow - new DateTime (1970, 1, 1);
+				scan_time = (int) since_epoch.TotalSeconds;
+
+				n_entries = entries.Length;
+				hash      = Hash (entries);
+
+				ArrayList dirs = new ArrayList ();
+				foreach (string entry in entries) {
+					if (entry [0] == 'd')
+						dirs.Add (entry.Substring (1));
+				}
+
+				Type string_type = typeof (string);
+				subdirs = (string []) dirs.ToArray (string_type);
+			}
+
+			public DirectoryState (IntPtr data)
+			{
+				IntPtr p = data;
+
+				p = Database.UnpackInt         (p, out mtime    );
+				p = Database.UnpackInt         (p, out scan_time);
+				p = Database.UnpackString      (p, out id       );
+				p = Database.UnpackInt         (p, out n_entries);
+				p = Database.UnpackInt         (p, out hash     );
+				p = Database.UnpackStringArray (p, out subdirs  );
+			}
+
+			// Properties
+			// Properties :: MTime (get;)
+			public int MTime {
+				get { return mtime; }
+			}
+
+			// Properties :: Id (get;)
+			/// <summary>
+			///	Device and inode, as "dev:ino".
+			/// </summary>
+			public string Id {
+				get { return id; }
+			}
+
+			// Properties :: Subdirs (get;)
+			/// <summary>
+			///	Names of the directories in this directory.
+			/// </summary>
+			public string [] Subdirs {
+				get { return subdirs; }
+			}
+
+			// Properties :: IsRacy (get;)
+			/// <summary>
+			///	Whether the directory was modified in the same
+			///	second it was read.
+			/// </summary>
+			/// <remarks>
+			///	Mtimes only have a resolution of one second, so
+			///	changes made right after reading wouldn't move it.
+			///	The entries of such a directory need to be compared
+			///	with <see cref="Matches" /> instead.
+			/// </remarks>
+			public bool IsRacy {
+				get { return mtime >= scan_time; }
+			}
+
+			// Methods
+			// Methods :: Public
+			// Methods :: Public :: Matches
+			/// <summary>
+			///	Whether <paramref name="entries" /> are the same
+			///	entries the directory had when it was read.
+			/// </summary>
+			public bool Matches (string [] entries)
+			{
+				return (entries.Length == n_entries &&
+					Hash (entries) == hash);
+			}
+
+			// Methods :: Public :: Pack
+			public IntPtr Pack (out int length)
+			{
+				IntPtr p;
+
+				p = Database.PackStart ();
+
+				Database.PackInt         (p, mtime    );
+				Database.PackInt         (p, scan_time);
+				Database.PackString      (p, id       );
+				Database.PackInt         (p, n_entries);
+				Database.PackInt         (p, hash     );
+				Database.PackStringArray (p, subdirs  );
+
+				return Database.PackEnd (p, out length);
+			}
+
+			// Methods :: Private
+			// Methods :: Private :: Hash
+			//	FNV-1a of every entry, summed so the order in which
+			//	the directory returns them doesn't matter. Stored
+			//	on disk, so don't use String.GetHashCode.
+			private static int Hash (string [] entries)
+			{
+				uint sum = 0;
+
+				foreach (string entry in entries) {
+					uint h = 2166136261;
+
+					foreach (char c in entry) {
+						h ^= c;
+						h *= 16777619;
+					}
+
+					sum += h;
+				}
+
+				return (int) sum;
+			}
+		}
+	}
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace Muine
+{
+	/// <summary>
+	///	Walks a directory tree in native code, handing out the
+	///	music files found in batches.
+	/// </summary>
+	/// <remarks>
+	///	Files which don't have a known music extension are
+	///	skipped before they ever reach managed code, and
+	///	directories are only read once, even if symlinks loop
+	///	back to them.
+	/// </remarks>
+	public class DirectoryWalker
+	{
+		// Objects
+		private IntPtr handle;
+
+		// Constructor
+		[DllImport ("libmuine")]
+		private static extern IntPtr dir_walker_new (string root);
+
+		/// <summary>
+		///	Create a new <see cref="DirectoryWalker" /> for the
+		///	tree below <paramref name="root" />.
+		/// </summary>
+		public DirectoryWalker (string root)
+		{
+			handle = dir_walker_new (root);
+		}
+
+		// Destructor
+		~DirectoryWalker ()
+		{
+			Close ();
+		}
+
+		// Static
+		// Static :: Methods
+		// Static :: Methods :: List
+		[DllImport ("libmuine")]
+		private static extern IntPtr dir_walker_list
+		  (string path, out int length);
+
+		/// <summary>
+		///	List a single directory, without descending into it.
+		/// </summary>
+		/// <remarks>
+		///	Every name is prefixed with 'd' for a directory, or
+		///	'f' for a music file. Other entries are left out.
+		/// </remarks>
+		/// <returns>
+		///	The prefixed names, or null if the directory can't be
+		///	read.
+		/// </returns>
+		public static string [] List (string path)
+		{
+			int length;
+			IntPtr buf = dir_walker_list (path, out length);
+			if (buf == IntPtr.Zero)
+				return null;
+
+			return SplitBuffer (buf, length);
+		}
+
+		// Static :: Methods :: IsMusicFile
+		[DllImport ("libmuine")]
+		private static extern bool dir_walker_is_audio_file (string filename);
+
+		/// <summary>
+		///	Whether <paramref name="filename" /> has a music
+		///	extension, the way the walker decides it.
+		/// </summary>
+		public static bool IsMusicFile (string filename)
+		{
+			return dir_walker_is_audio_file (filename);
+		}
+
+		// Static :: Methods :: SplitBuffer
+		//	Splits and frees a buffer of NUL-terminated strings
+		private static string [] SplitBuffer (IntPtr buf, int length)
+		{
+			byte [] bytes = new byte [length];
+			Marshal.Copy (buf, bytes, 0, length);
+			GLib.Marshaller.Free (buf);
+
+			ArrayList strings = new ArrayList ();
+
+			int start = 0;
+			for (int i = 0; i < length; i++) {
+				if (bytes [i] != 0)
+					continue;
+
+				strings.Add (Encoding.UTF8.GetString (bytes, start, i - start));
+				start = i + 1;
+			}
+
+			Type string_type = typeof (string);
+			return (string []) strings.ToArray (string_type);
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: NextBatch
+		[DllImport ("libmuine")]
+		private static extern IntPtr dir_walker_next_batch
+		  (IntPtr walker, int max_paths, out int length);
+
+		/// <summary>
+		///	Get the next music files.
+		/// </summary>
+		/// <param name="max_paths">
+		///	The maximum number of files to return.
+		/// </param>
+		/// <returns>
+		///	The full paths of up to <paramref name="max_paths" />
+		///	files, or null once the whole tree has been walked.
+		/// </returns>
+		public string [] NextBatch (int max_paths)
+		{
+			if (handle == IntPtr.Zero)
+				return null;
+
+			int length;
+			IntPtr buf = dir_walker_next_batch (handle, max_paths, out length);
+			if (buf == IntPtr.Zero)
+				return null;
+
+			return SplitBuffer (buf, length);
+		}
+
+		// Methods :: Public :: Close
+		[DllImport ("libmuine")]
+		private static extern void dir_walker_free (IntPtr walker);
+
+		/// <summary>
+		///	Free the native walker. Safe to call more than once.
+		/// </summary>
+		public void Close ()
+		{
+			if (handle == IntPtr.Zero)
+				return;
+
+			dir_walker_free (handle);
+			handle = IntPtr.Zero;
+
+			GC.SuppressFinalize (this);
+		}
+	}
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+
+namespace Muine
+{
+	/// <summary>
+	///	Remembers which file each song was read from, by device,
+	///	inode, size and mtime.
+	/// </summary>
+	/// <remarks>
+	///	None of those change when a file is renamed or moved within
+	///	a file system, so songs which vanished can be found again at
+	///	their new location without reading their tags.
+	/// </remarks>
+	public class FileIdDatabase
+	{
+		// Objects
+		private Database db;
+		private Hashtable ids;
+
+		// Variables
+		private bool loaded = false;
+
+		// Constructor
+		/// <summary>
+		///	Create a <see cref="FileIdDatabase" /> object.
+		/// </summary>
+		/// <param name="version">
+		///	Version of the database to use.
+		/// </param>
+		public FileIdDatabase (int version)
+		{
+			db = new Database (FileUtils.FileIdsDBFile, version);
+
+			ids = new Hashtable ();
+		}
+
+		// Indexers
+		/// <summary>
+		///	The identity of the file at <paramref name="path" />
+		///	when we last saw it, or null if we don't know it.
+		/// </summary>
+		public FileId this [string path] {
+			get { lock (this) return (FileId) ids [path]; }
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Load
+		/// <summary>
+		///	Load the database, unless that was done already.
+		/// </summary>
+		public void Load ()
+		{
+			lock (this) {
+				if (loaded)
+					return;
+
+				db.Load (new Database.DecodeFunctionDelegate (DecodeFunction));
+				loaded = true;
+			}
+		}
+
+		// Methods :: Public :: Store
+		public void Store (string path, FileId id)
+		{
+			lock (this) {
+				FileId old_id = (FileId) ids [path];
+				if (old_id != null && old_id.Key == id.Key)
+					return;
+
+				ids [path] = id;
+
+				int data_size;
+				IntPtr data = id.Pack (out data_size);
+				db.Store (path, data, data_size, true);
+			}
+		}
+
+		// Methods :: Public :: Remove
+		//	Also deletes the record if the database isn't loaded yet.
+		public void Remove (string path)
+		{
+			lock (this) {
+				ids.Remove (path);
+				db.Delete (path);
+			}
+		}
+
+		// Methods :: Public :: Move
+		/// <summary>
+		///	Rekey the identity of <paramref name="old_path" /> to
+		///	<paramref name="new_path" />.
+		/// </summary>
+		public void Move (string old_path, string new_path)
+		{
+			lock (this) {
+				FileId id = (FileId) ids [old_path];
+
+				Remove (old_path);
+
+				if (id != null)
+					Store (new_path, id);
+			}
+		}
+
+		// Delegate Functions
+		// Delegate Functions :: DecodeFunction
+		private void DecodeFunction (string key, IntPtr data)
+		{
+			ids [key] = new FileId (data);
+		}
+
+		// Internal Classes
+		// Internal Classes :: FileId
+		public class FileId
+		{
+			// Variables
+			private long device;
+			private long inode;
+			private long size;
+			private int  mtime;
+
+			// Constructor
+			public FileId (ulong device, ulong inode, long size, int mtime)
+			{
+				this.device = (long) device;
+				this.inode  = (long) inode;
+				this.size   = size;
+				this.mtime  = mtime;
+			}
+
+			public FileId (IntPtr data)
+			{
+				IntPtr p = data;
+
+				p = Database.UnpackLong (p, out device);
+				p = Database.UnpackLong (p, out inode );
+				p = Database.UnpackLong (p, out size  );
+				p = Database.UnpackInt  (p, out mtime );
+			}
+
+			// Properties
+			// Properties :: Key (get;)
+			/// <summary>
+			///	A string which is the same for two
+			///	<see cref="FileId" />s only if they are the same
+			///	file, unchanged.
+			/// </summary>
+			public string Key {
+				get {
+					return String.Format ("{0}:{1}:{2}:{3}",
+						device, inode, size, mtime);
+				}
+			}
+
+			// Methods
+			// Methods :: Public
+			// Methods :: Public :: Pack
+			public IntPtr Pack (out int length)
+			{
+				IntPtr p;
+
+				p = Database.PackStart ();
+
+				Database.PackLong (p, device);
+				Database.PackLong (p, inode );
+				Database.PackLong (p, size  );
+				Database.PackInt  (p, mtime );
+
+				return Database.PackEnd (p, out length);
+			}
+		}
+	}
+}
@@ -33,6 +33,11 @@ namespace Muine
 		private const string playlist_filename = "playlist.m3u";
 		private const string songsdb_filename  = "songs.db"    ;
 		private const string coversdb_filename = "covers.db"   ;
+		private const string dirsdb_filename   = "directories.db";
+		private const string rejectsdb_filename = "rejected.db";
+		private const string idsdb_filename    = "fileids.db";
+		private const string lookupsdb_filename = "coverlookups.db";
+		private const string responses_dirname = "cover-responses";
 		private const string plugin_dirname    = "plugins"     ;
 
 		private readonly static DateTime date_time_1970 = 
@@ -56,6 +61,11 @@ namespace Muine
 		private static string playlist_file;
 		private static string songsdb_file;
 		private static string coversdb_file;
+		private static string dirsdb_file;
+		private static string rejectsdb_file;
+		private static string idsdb_file;
+		private static string lookupsdb_file;
+		private static string responses_directory;
 		private static string user_plugin_directory;
 		private static string temp_directory;
 
@@ -108,6 +118,21 @@ namespace Muine
 			coversdb_file =
 			  Path.Combine (config_directory, coversdb_filename);
 
+			dirsdb_file =
+			  Path.Combine (config_directory, dirsdb_filename);
+
+			rejectsdb_file =
+			  Path.Combine (config_directory, rejectsdb_filename);
+
+			idsdb_file =
+			  Path.Combine (config_directory, idsdb_filename);
+
+			lookupsdb_file =
+			  Path.Combine (config_directory, lookupsdb_filename);
+
+			responses_directory =
+			  Path.Combine (config_directory, responses_dirname);
+
 			user_plugin_directory =
 			  Path.Combine (config_directory, plugin_dirname);
 			
@@ -194,6 +219,79 @@ namespace Muine
 			get { return coversdb_file; }
 		}
 
+		// Properties :: DirectoriesDBFile (get;)
+		/// <summary>
+		/// 	The path to the database of directory states.
+		/// </summary>
+		/// <remarks>
+		///	This should be ~/.gnome2/muine/directories.db or similar.
+		/// </remarks>
+		/// <returns>
+		///	The absolute path to the directories database.
+		/// </returns>
+		public static string DirectoriesDBFile {
+			get { return dirsdb_file; }
+		}
+
+		// Properties :: RejectedDBFile (get;)
+		/// <summary>
+		/// 	The path to the database of files which turned out
+		/// 	not to be music.
+		/// </summary>
+		/// <remarks>
+		///	This should be ~/.gnome2/muine/rejected.db or similar.
+		/// </remarks>
+		/// <returns>
+		///	The absolute path to the rejected files database.
+		/// </returns>
+		public static string RejectedDBFile {
+			get { return rejectsdb_file; }
+		}
+
+		// Properties :: FileIdsDBFile (get;)
+		/// <summary>
+		/// 	The path to the database of song file identities.
+		/// </summary>
+		/// <remarks>
+		///	This should be ~/.gnome2/muine/fileids.db or similar.
+		/// </remarks>
+		/// <returns>
+		///	The absolute path to the file identities database.
+		/// </returns>
+		public static string FileIdsDBFile {
+			get { return idsdb_file; }
+		}
+
+		// Properties :: CoverLookupsDBFile (get;)
+		/// <summary>
+		/// 	The path to the database of cover lookup outcomes.
+		/// </summary>
+		/// <remarks>
+		///	This should be ~/.gnome2/muine/coverlookups.db or similar.
+		/// </remarks>
+		/// <returns>
+		///	The absolute path to the cover lookups database.
+		/// </returns>
+		public static string CoverLookupsDBFile {
+			get { return lookupsdb_file; }
+		}
+
+		// Properties :: CoverResponsesDirectory (get;)
+		/// <summary>
+		/// 	The directory in which MusicBrainz and Amazon
+		/// 	responses are cached.
+		/// </summary>
+		/// <remarks>
+		///	This should be ~/.gnome2/muine/cover-responses or
+		///	similar. It may not exist yet.
+		/// </remarks>
+		/// <returns>
+		///	The absolute path to the response cache directory.
+		/// </returns>
+		public static string CoverResponsesDirectory {
+			get { return responses_directory; }
+		}
+
 		// Properties :: SystemPluginDirectory (get;)
 		/// <summary>
 		///	Path to the system-wide plugins directory.
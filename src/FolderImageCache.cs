@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+using System.IO;
+
+using Gdk;
+
+namespace Muine
+{
+	/// <summary>
+	///	The cover image found in each folder, so a folder is only
+	///	searched once for all the songs in it.
+	/// </summary>
+	/// <remarks>
+	///	A folder is searched again when its mtime changes, which
+	///	happens when files are added, removed or renamed, or when
+	///	the image that was chosen is modified. Folders without an
+	///	image are remembered too. Only the folders used most
+	///	recently are kept; songs from the same folder are usually
+	///	added together.
+	/// </remarks>
+	public class FolderImageCache
+	{
+		// Constants
+		private const int MaxFolders = 64;
+
+		// Delegates
+		/// <summary>
+		///	Loads <paramref name="file" /> as a cover.
+		/// </summary>
+		/// <exception cref="GLib.GException">
+		///	Thrown if the image can't be loaded.
+		/// </exception>
+		public delegate Pixbuf LoadFunction (string file);
+
+		// Objects
+		//	Folder => Entry
+		private Hashtable entries = new Hashtable ();
+
+		//	Least recently used first
+		private ArrayList folders = new ArrayList ();
+
+		private LoadFunction load_func;
+
+		// Variables
+		//	Lower-case, best first
+		private string [] names;
+
+		// Constructor
+		/// <summary>
+		///	Create a new <see cref="FolderImageCache" />.
+		/// </summary>
+		/// <param name="names">
+		///	The file names that are used for covers, best first.
+		///	They are matched regardless of case.
+		/// </param>
+		/// <param name="load_func">
+		///	A <see cref="LoadFunction" /> to make a cover of the
+		///	image that's found.
+		/// </param>
+		public FolderImageCache (string [] names, LoadFunction load_func)
+		{
+			this.names = new string [names.Length];
+			for (int i = 0; i < names.Length; i ++)
+				this.names [i] = names [i].ToLower ();
+
+			this.load_func = load_func;
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Get
+		/// <summary>
+		///	The cover for <paramref name="folder" />.
+		/// </summary>
+		/// <remarks>
+		///	The same <see cref="Gdk.Pixbuf" /> is returned for
+		///	every song in the folder, so it must not be changed.
+		/// </remarks>
+		/// <returns>
+		///	A <see cref="Gdk.Pixbuf" />, or null if the folder has
+		///	no image which can be loaded.
+		/// </returns>
+		public Pixbuf Get (string folder)
+		{
+			lock (this) {
+				DateTime mtime;
+
+				try {
+					mtime = Directory.GetLastWriteTimeUtc (folder);
+				} catch (Exception) {
+					return null;
+				}
+
+				Entry entry = (Entry) entries [folder];
+
+				if (entry == null || !entry.IsValid (mtime)) {
+					entry = Scan (folder, mtime);
+					entries [folder] = entry;
+				}
+
+				// Move to the end
+				folders.Remove (folder);
+				folders.Add (folder);
+
+				if (folders.Count > MaxFolders) {
+					entries.Remove (folders [0]);
+					folders.RemoveAt (0);
+				}
+
+				return entry.Cover;
+			}
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: Scan
+		//	Ranks the images in the folder by their name, and loads
+		//	the best one which works.
+		private Entry Scan (string folder, DateTime mtime)
+		{
+			Entry entry = new Entry (mtime);
+
+			string [] files;
+
+			try {
+				files = Directory.GetFiles (folder);
+			} catch (Exception) {
+				return entry;
+			}
+
+			//	Lower-case name => file
+			Hashtable by_name = new Hashtable ();
+
+			foreach (string file in files) {
+				string name = Path.GetFileName (file).ToLower ();
+
+				if (!by_name.ContainsKey (name))
+					by_name [name] = file;
+			}
+
+			foreach (string name in names) {
+				string file = (string) by_name [name];
+				if (file == null)
+					continue;
+
+				try {
+					entry.Cover = load_func (file);
+				} catch {
+					continue;
+				}
+
+				entry.File = file;
+				entry.FileMtime = File.GetLastWriteTimeUtc (file);
+				break;
+			}
+
+			return entry;
+		}
+
+		// Internal Classes
+		// Internal Classes :: Entry
+		private class Entry
+		{
+			public DateTime Mtime;
+
+			//	The chosen image, if any
+			public string   File      = null;
+			public DateTime FileMtime;
+			public Pixbuf   Cover     = null;
+
+			// Constructor
+			public Entry (DateTime mtime)
+			{
+				Mtime = mtime;
+			}
+
+			// Methods
+			// Methods :: Public
+			// Methods :: Public :: IsValid
+			//	Writing to a file doesn't change the folder's
+			//	mtime, so check the chosen image as well.
+			public bool IsValid (DateTime mtime)
+			{
+				if (mtime != Mtime)
+					return false;
+
+				if (File == null)
+					return true;
+
+				try {
+					return (System.IO.File.GetLastWriteTimeUtc (File) == FileMtime);
+				} catch (Exception) {
+					return false;
+				}
+			}
+		}
+	}
+}
@@ -39,6 +39,10 @@ namespace Muine
 		// Delegates :: Internal
 		internal delegate int CompareFuncNative (IntPtr a, IntPtr b);
 
+		// Variables
+		private IntPtr [] snapshot = null;
+		private uint snapshot_version;
+
 		// Constructor
 		[DllImport("libmuine")]
 		private static extern IntPtr pointer_list_model_new ();
@@ -116,6 +120,49 @@ namespace Muine
 			}
 		}
 
+		// Properties :: Snapshot (get;)
+		[DllImport("libmuine")]
+		private static extern int pointer_list_model_copy_pointers
+		  (IntPtr raw, [Out] IntPtr [] pointers, int n_pointers);
+
+		/// <summary>
+		///	The handles in the model, in order.
+		/// </summary>
+		/// <remarks>
+		///	The array is only rebuilt when <see cref="Version" />
+		///	moves, and is shared between all callers until then.
+		///	Don't modify it. It is safe to keep iterating it while
+		///	changing the model.
+		/// </remarks>
+		public IntPtr [] Snapshot {
+			get {
+				uint version = Version;
+
+				if (snapshot != null && snapshot_version == version)
+					return snapshot;
+
+				IntPtr [] array = new IntPtr [Length];
+				pointer_list_model_copy_pointers (Raw, array, array.Length);
+
+				snapshot = array;
+				snapshot_version = version;
+
+				return snapshot;
+			}
+		}
+
+		// Properties :: Version (get;)
+		[DllImport("libmuine")]
+		private static extern uint pointer_list_model_get_version (IntPtr raw);
+
+		/// <summary>
+		///	A counter that changes whenever handles are added,
+		///	removed or reordered.
+		/// </summary>
+		public uint Version {
+			get { return pointer_list_model_get_version (Raw); }
+		}
+
 		// Properties :: Length (get;)
 		public int Length {
 			get { return IterNChildren (); }
@@ -195,6 +242,32 @@ namespace Muine
 			pointer_list_model_remove (Raw, handle);
 		}
 
+		// Methods :: Public :: RemoveHandles
+		[DllImport("libmuine")]
+		private static extern bool pointer_list_model_remove_pointers
+		  (IntPtr raw, IntPtr [] pointers, int n_pointers);
+
+		/// <summary>
+		///	Remove several handles at once.
+		/// </summary>
+		/// <remarks>
+		///	If the playing handle is removed, the next remaining
+		///	one (or else the previous one) starts playing.
+		/// </remarks>
+		/// <returns>
+		///	True if <see cref="Playing" /> changed.
+		/// </returns>
+		public bool RemoveHandles (IntPtr [] handles)
+		{
+			bool changed =
+			  pointer_list_model_remove_pointers (Raw, handles, handles.Length);
+
+			if (changed && PlayingChanged != null)
+				PlayingChanged (Playing);
+
+			return changed;
+		}
+
 		// Methods :: Public :: RemoveDelta
 		[DllImport("libmuine")]
 		private static extern void pointer_list_model_remove_delta
@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+using System.IO;
+using System.Threading;
+
+namespace Muine
+{
+	/// <summary>
+	///	Reads the tags of submitted files on a pool of worker
+	///	threads, and hands the resulting songs back in the order
+	///	the files were submitted.
+	/// </summary>
+	/// <remarks>
+	///	<see cref="Submit" /> blocks while too many files are in
+	///	flight, so a fast directory walk can't run away from the
+	///	tag readers. The <see cref="CommitFunc" /> is called from a
+	///	single thread of its own.
+	///
+	///	Files which aren't music are recognized by their first bytes
+	///	where possible, and remembered in a
+	///	<see cref="RejectedFileDatabase" />, so later imports skip
+	///	them without reading them at all.
+	///
+	///	Reads are scheduled by <see cref="ImportScheduler" />, so
+	///	they don't get in the way of playback.
+	/// </remarks>
+	public class ImportPipeline
+	{
+		// Constants
+		// Constants :: MaxWorkers
+		private const int MaxWorkers = 8;
+
+		// Constants :: WindowPerWorker
+		//	Number of files per worker that may be submitted but
+		//	not yet committed
+		private const int WindowPerWorker = 32;
+
+		// Delegates
+		public delegate void CommitFunc (string filename, Song song);
+
+		// Objects
+		private CommitFunc commit_func;
+		private RejectedFileDatabase rejects;
+		private Thread [] workers;
+		private Thread committer;
+
+		private Queue     work    = new Queue ();
+		private Hashtable results = new Hashtable ();
+
+		// Variables
+		private int window;
+		private int next_seq    = 0;
+		private int next_commit = 0;
+		private int n_read      = 0;
+		private bool input_done = false;
+		private bool canceled   = false;
+		private DateTime start_time;
+
+		// Constructor
+		/// <summary>
+		///	Create a new <see cref="ImportPipeline" />.
+		/// </summary>
+		/// <param name="commit_func">
+		///	Called for every song read.
+		/// </param>
+		/// <param name="rejects">
+		///	Files known not to be music, or null.
+		/// </param>
+		public ImportPipeline (CommitFunc commit_func, RejectedFileDatabase rejects)
+		{
+			this.commit_func = commit_func;
+			this.rejects     = rejects;
+
+			int n_workers = Environment.ProcessorCount;
+			n_workers = Math.Max (1, Math.Min (n_workers, MaxWorkers));
+
+			window = n_workers * WindowPerWorker;
+
+			workers = new Thread [n_workers];
+			for (int i = 0; i < n_workers; i++)
+				workers [i] = NewThread (new ThreadStart (WorkerFunc));
+
+			committer = NewThread (new ThreadStart (CommitterFunc));
+		}
+
+		// Properties
+		// Properties :: NWorkers (get;)
+		public int NWorkers {
+			get { return workers.Length; }
+		}
+
+		// Properties :: NWaitingToRead (get;)
+		/// <summary>
+		///	Files submitted whose tags haven't been read yet.
+		/// </summary>
+		public int NWaitingToRead {
+			get { lock (this) return work.Count; }
+		}
+
+		// Properties :: NWaitingToCommit (get;)
+		/// <summary>
+		///	Files read, but waiting for earlier ones to be
+		///	committed first.
+		/// </summary>
+		public int NWaitingToCommit {
+			get { lock (this) return results.Count; }
+		}
+
+		// Properties :: FilesPerSecond (get;)
+		/// <summary>
+		///	The number of files read per second since
+		///	<see cref="Start" />.
+		/// </summary>
+		public double FilesPerSecond {
+			get {
+				TimeSpan elapsed = DateTime.Now - start_time;
+				if (elapsed.TotalSeconds <= 0)
+					return 0;
+
+				return n_read / elapsed.TotalSeconds;
+			}
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Start
+		public void Start ()
+		{
+			if (rejects != null)
+				rejects.Load ();
+
+			start_time = DateTime.Now;
+
+			foreach (Thread worker in workers)
+				worker.Start ();
+
+			committer.Start ();
+		}
+
+		// Methods :: Public :: Submit
+		/// <summary>
+		///	Queue a file for reading.
+		/// </summary>
+		/// <returns>
+		///	False if the pipeline was canceled.
+		/// </returns>
+		public bool Submit (string filename)
+		{
+			return Submit (filename, null);
+		}
+
+		/// <summary>
+		///	Queue a file for reading, unless <paramref name="song" />
+		///	is known already.
+		/// </summary>
+		/// <remarks>
+		///	A known song isn't read again, but it is still committed
+		///	in order with the files around it.
+		/// </remarks>
+		/// <returns>
+		///	False if the pipeline was canceled.
+		/// </returns>
+		public bool Submit (string filename, Song song)
+		{
+			lock (this) {
+				while (!canceled && next_seq - next_commit >= window)
+					Monitor.Wait (this);
+
+				if (canceled)
+					return false;
+
+				WorkItem item = new WorkItem (next_seq, filename);
+
+				if (song == null) {
+					work.Enqueue (item);
+
+				} else {
+					item.Song = song;
+					results [item.Seq] = item;
+				}
+
+				next_seq ++;
+
+				Monitor.PulseAll (this);
+			}
+
+			return true;
+		}
+
+		// Methods :: Public :: Finish
+		/// <summary>
+		///	Signal that no more files will be submitted, and wait
+		///	until all submitted files have been committed.
+		/// </summary>
+		public void Finish ()
+		{
+			lock (this) {
+				input_done = true;
+				Monitor.PulseAll (this);
+			}
+
+			committer.Join ();
+
+			foreach (Thread worker in workers)
+				worker.Join ();
+		}
+
+		// Methods :: Public :: Cancel
+		/// <summary>
+		///	Stop reading and committing. Files that were already
+		///	submitted are dropped.
+		/// </summary>
+		public void Cancel ()
+		{
+			lock (this) {
+				canceled = true;
+				Monitor.PulseAll (this);
+			}
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: NewThread
+		private Thread NewThread (ThreadStart start)
+		{
+			Thread thread = new Thread (start);
+			thread.IsBackground = true;
+			thread.Priority = ThreadPriority.BelowNormal;
+
+			return thread;
+		}
+
+		// Methods :: Private :: ReadSong
+		//	Returns null if the file can't be read, or isn't music.
+		private Song ReadSong (string filename)
+		{
+			int mtime = 0;
+			long size = 0;
+			bool have_stat = false;
+
+			if (rejects != null) {
+				Mono.Unix.Native.Stat buf;
+				if (Mono.Unix.Native.Syscall.stat (filename, out buf) == 0) {
+					mtime = (int) buf.st_mtime;
+					size  = buf.st_size;
+					have_stat = true;
+
+					if (rejects.Contains (filename, mtime, size))
+						return null;
+				}
+			}
+
+			// Much cheaper than letting the tag reader fail
+			if (AudioSniffer.Check (filename) == AudioSniffer.Result.NotAudio) {
+				if (have_stat)
+					rejects.Add (filename, mtime, size);
+
+				return null;
+			}
+
+			Song song;
+
+			try {
+				song = new Song (filename);
+
+			} catch (IOException) {
+				// Might be readable next time
+				return null;
+
+			} catch (UnauthorizedAccessException) {
+				return null;
+
+			} catch {
+				if (have_stat)
+					rejects.Add (filename, mtime, size);
+
+				return null;
+			}
+
+			// It may have been rejected in an earlier form
+			if (rejects != null)
+				rejects.Remove (filename);
+
+			return song;
+		}
+
+		// Delegate Functions
+		// Delegate Functions :: WorkerFunc
+		private void WorkerFunc ()
+		{
+			ImportScheduler.EnterImportThread ();
+
+			while (true) {
+				WorkItem item;
+
+				lock (this) {
+					while (!canceled && work.Count == 0 && !input_done)
+						Monitor.Wait (this);
+
+					if (canceled || work.Count == 0)
+						return;
+
+					item = (WorkItem) work.Dequeue ();
+				}
+
+				ImportScheduler.WaitTurn ();
+
+				item.Song = ReadSong (item.Filename);
+
+				lock (this) {
+					results [item.Seq] = item;
+					n_read ++;
+
+					Monitor.PulseAll (this);
+				}
+			}
+		}
+
+		// Delegate Functions :: CommitterFunc
+		private void CommitterFunc ()
+		{
+			while (true) {
+				WorkItem item;
+
+				lock (this) {
+					while (!canceled && !results.ContainsKey (next_commit) &&
+					       !(input_done && next_commit == next_seq))
+						Monitor.Wait (this);
+
+					if (canceled || !results.ContainsKey (next_commit))
+						return;
+
+					item = (WorkItem) results [next_commit];
+					results.Remove (next_commit);
+					next_commit ++;
+
+					Monitor.PulseAll (this);
+				}
+
+				if (item.Song != null)
+					commit_func (item.Filename, item.Song);
+			}
+		}
+
+		// Internal Classes
+		// Internal Classes :: WorkItem
+		private class WorkItem
+		{
+			public int    Seq;
+			public string Filename;
+			public Song   Song = null;
+
+			// Constructor
+			public WorkItem (int seq, string filename)
+			{
+				Seq      = seq;
+				Filename = filename;
+			}
+		}
+	}
+}
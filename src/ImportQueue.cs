@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+
+namespace Muine
+{
+	/// <summary>
+	///	The folders waiting to be imported.
+	/// </summary>
+	/// <remarks>
+	///	A folder inside one that is already queued or being
+	///	imported is not queued again, and queued folders inside a
+	///	newly added one are folded into it. Folders are handed out
+	///	by priority, and in the order they were added otherwise.
+	/// </remarks>
+	public class ImportQueue
+	{
+		// Enums
+		// Enums :: Priority
+		public enum Priority {
+			Background,
+			User
+		}
+
+		// Objects
+		private ArrayList pending   = new ArrayList ();
+		private ArrayList in_flight = new ArrayList ();
+
+		// Properties
+		// Properties :: Count (get;)
+		/// <summary>
+		///	The number of folders waiting to be imported, not
+		///	counting those being imported.
+		/// </summary>
+		public int Count {
+			get { lock (this) return pending.Count; }
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Add
+		/// <summary>
+		///	Queue <paramref name="folder" />.
+		/// </summary>
+		/// <returns>
+		///	False if it's already covered by a folder which is
+		///	queued or being imported.
+		/// </returns>
+		public bool Add (string folder, Priority priority)
+		{
+			folder = Normalize (folder);
+
+			lock (this) {
+				foreach (string f in in_flight) {
+					if (Contains (f, folder))
+						return false;
+				}
+
+				foreach (Job job in pending) {
+					if (!Contains (job.Folder, folder))
+						continue;
+
+					if (priority > job.Priority)
+						job.Priority = priority;
+
+					return false;
+				}
+
+				// Fold in what it covers
+				for (int i = pending.Count - 1; i >= 0; i--) {
+					Job job = (Job) pending [i];
+					if (!Contains (folder, job.Folder))
+						continue;
+
+					if (job.Priority > priority)
+						priority = job.Priority;
+
+					pending.RemoveAt (i);
+				}
+
+				pending.Add (new Job (folder, priority));
+			}
+
+			return true;
+		}
+
+		// Methods :: Public :: Next
+		/// <summary>
+		///	Take the next folder to import, and mark it as being
+		///	imported until <see cref="Done" /> is called.
+		/// </summary>
+		/// <returns>
+		///	The folder, or null if the queue is empty.
+		/// </returns>
+		public string Next ()
+		{
+			lock (this) {
+				if (pending.Count == 0)
+					return null;
+
+				int best = 0;
+				for (int i = 1; i < pending.Count; i++) {
+					Job job = (Job) pending [i];
+					if (job.Priority > ((Job) pending [best]).Priority)
+						best = i;
+				}
+
+				string folder = ((Job) pending [best]).Folder;
+				pending.RemoveAt (best);
+				in_flight.Add (folder);
+
+				return folder;
+			}
+		}
+
+		// Methods :: Public :: Done
+		public void Done (string folder)
+		{
+			lock (this)
+				in_flight.Remove (folder);
+		}
+
+		// Methods :: Public :: Clear
+		/// <summary>
+		///	Drop the folders which are waiting.
+		/// </summary>
+		public void Clear ()
+		{
+			lock (this)
+				pending.Clear ();
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: Normalize
+		private static string Normalize (string folder)
+		{
+			if (folder.Length > 1 && folder.EndsWith ("/"))
+				return folder.TrimEnd ('/');
+
+			return folder;
+		}
+
+		// Methods :: Private :: Contains
+		//	Whether folder is parent, or inside it
+		private static bool Contains (string parent, string folder)
+		{
+			if (folder == parent)
+				return true;
+
+			if (parent == "/")
+				return true;
+
+			return folder.StartsWith (parent + "/");
+		}
+
+		// Internal Classes
+		// Internal Classes :: Job
+		private class Job
+		{
+			public string   Folder;
+			public Priority Priority;
+
+			// Constructor
+			public Job (string folder, Priority priority)
+			{
+				Folder   = folder;
+				Priority = priority;
+			}
+		}
+	}
+}
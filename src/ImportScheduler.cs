@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace Muine
+{
+	/// <summary>
+	///	Keeps imports out of the way of playback.
+	/// </summary>
+	/// <remarks>
+	///	Import threads run in the idle I/O class, so the disk
+	///	serves the song being played first. On top of that, they
+	///	call <see cref="WaitTurn" /> before reading, which holds
+	///	them back while the player is running short of data, and
+	///	for a moment after the song changes, while the new one
+	///	is being opened.
+	/// </remarks>
+	public static class ImportScheduler
+	{
+		// GConf
+		private const string GConfKeyTrackChangePause = "/apps/muine/import_track_change_pause";
+		private const int GConfDefaultTrackChangePause = 2000;
+
+		// Constants
+		// Constants :: MaxStall
+		//	Milliseconds a read is held back at most, so an import
+		//	still trickles on if the player keeps complaining
+		private const int MaxStall = 5000;
+
+		// Objects
+		private static object sync = new object ();
+
+		// Variables
+		private static bool starving = false;
+		private static DateTime quiet_until = DateTime.MinValue;
+		private static int n_stalls = 0;
+
+		// Properties
+		// Properties :: NStalls (get;)
+		/// <summary>
+		///	The number of reads that were held back so far.
+		/// </summary>
+		public static int NStalls {
+			get { lock (sync) return n_stalls; }
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: EnterImportThread
+		[DllImport ("libmuine")]
+		private static extern bool io_priority_set_idle ();
+
+		/// <summary>
+		///	Put the calling thread in the idle I/O class. Threads
+		///	it starts afterwards inherit this.
+		/// </summary>
+		public static void EnterImportThread ()
+		{
+			io_priority_set_idle ();
+		}
+
+		// Methods :: Public :: SetStarving
+		/// <summary>
+		///	Tell whether the player is running short of data.
+		/// </summary>
+		public static void SetStarving (bool starving)
+		{
+			lock (sync) {
+				ImportScheduler.starving = starving;
+
+				Monitor.PulseAll (sync);
+			}
+		}
+
+		// Methods :: Public :: TrackChanging
+		/// <summary>
+		///	Hold imports back while a new song is opened.
+		/// </summary>
+		public static void TrackChanging ()
+		{
+			int pause = (int) Config.Get (GConfKeyTrackChangePause,
+				GConfDefaultTrackChangePause);
+
+			lock (sync) {
+				DateTime until = DateTime.Now.AddMilliseconds (pause);
+				if (until > quiet_until)
+					quiet_until = until;
+			}
+		}
+
+		// Methods :: Public :: WaitTurn
+		/// <summary>
+		///	Block while imports should stay off the disk, but no
+		///	longer than <see cref="MaxStall" />.
+		/// </summary>
+		/// <remarks>
+		///	Call this from an import thread before reading.
+		/// </remarks>
+		public static void WaitTurn ()
+		{
+			lock (sync) {
+				DateTime deadline = DateTime.Now.AddMilliseconds (MaxStall);
+				bool stalled = false;
+
+				while (true) {
+					DateTime now = DateTime.Now;
+					if (now >= deadline)
+						break;
+
+					DateTime until;
+					if (starving)
+						until = deadline;
+					else if (now < quiet_until)
+						until = (quiet_until < deadline) ? quiet_until : deadline;
+					else
+						break;
+
+					if (!stalled) {
+						stalled = true;
+						n_stalls ++;
+					}
+
+					Monitor.Wait (sync, until - now);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace Muine
+{
+	/// <summary>
+	///	Stats and reads many files at once, keeping the requests
+	///	in flight together rather than one after the other.
+	/// </summary>
+	/// <remarks>
+	///	Uses io_uring where available, and a few threads otherwise.
+	///	Both methods block until the whole batch is done, so call
+	///	them from a thread.
+	/// </remarks>
+	public static class IoBatch
+	{
+		// Structs
+		// Structs :: StatResult
+		[StructLayout (LayoutKind.Sequential)]
+		public struct StatResult
+		{
+			public int   Error; // errno, or 0
+			public int   MTime;
+			public long  Size;
+			public ulong Device;
+			public ulong Inode;
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Stat
+		[DllImport ("libmuine")]
+		private static extern void io_batch_stat
+		  (string [] paths, int n_paths, [Out] StatResult [] results);
+
+		/// <summary>
+		///	Stat <paramref name="paths" />.
+		/// </summary>
+		/// <returns>
+		///	One <see cref="StatResult" /> per path, in the same
+		///	order.
+		/// </returns>
+		public static StatResult [] Stat (string [] paths)
+		{
+			StatResult [] results = new StatResult [paths.Length];
+
+			io_batch_stat (paths, paths.Length, results);
+
+			return results;
+		}
+
+		// Methods :: Public :: Prefetch
+		[DllImport ("libmuine")]
+		private static extern void io_batch_prefetch
+		  (string [] paths, int n_paths);
+
+		/// <summary>
+		///	Read the start and end of <paramref name="paths" />,
+		///	where tags are kept, into the page cache.
+		/// </summary>
+		public static void Prefetch (string [] paths)
+		{
+			io_batch_prefetch (paths, paths.Length);
+		}
+	}
+}
@@ -32,9 +32,8 @@ namespace Muine
 	
 		// Properties
 		// Properties :: Abstract
-		// Properties :: Abstract :: CoverImage (set; get;)
+		// Properties :: Abstract :: CoverImage (get;)
 		public abstract Gdk.Pixbuf CoverImage {
-			set;
 			get;
 		}
 
@@ -73,6 +72,8 @@ namespace Muine
 		// Methods :: Abstract
 		public abstract void Deregister ();
 
+		public abstract void EmitCoverChanged ();
+
 		protected abstract SortKey GenerateSortKey ();
 
 		protected abstract string GenerateSearchKey ();
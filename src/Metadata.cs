@@ -247,21 +247,12 @@ namespace Muine
 
 		private Gdk.Pixbuf GetPixbuf (ByteVector data)
 		{
-			bool bail = false;
-			Gdk.Pixbuf output;
-			Gdk.PixbufLoader loader = new Gdk.PixbufLoader ();
+			Gdk.Pixbuf output = null;
 
+			// Decoded straight at cover size, it's only used for that
 			try {
-				if (!loader.Write (data.Data))
-					bail = true;
-			} catch {bail = true;}
-
-			try {
-				if (!loader.Close ())
-					bail = true;
-			} catch {bail = true;}
-
-			output = (!bail) ? loader.Pixbuf : null;
+				output = PixbufUtils.LoadAtSize (data.Data, CoverGetter.TargetSize);
+			} catch {}
 
 			return output;
 		}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.IO;
+
+using Gdk;
+
+namespace Muine
+{
+	public static class PixbufUtils
+	{
+		// Constants
+		private const int ChunkSize = 16384;
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: LoadAtSize
+		/// <summary>
+		///	Load an image, scaled down to fit in a square of
+		///	<paramref name="size" /> pixels while it's decoded.
+		/// </summary>
+		/// <remarks>
+		///	The loader is told the size before it decodes anything,
+		///	so a JPEG is decoded at a fraction of its size right away,
+		///	and the full size image is never held in memory. Images
+		///	which already fit are not scaled up.
+		/// </remarks>
+		/// <exception cref="GLib.GException">
+		///	Thrown if the image can't be loaded.
+		/// </exception>
+		public static Pixbuf LoadAtSize (string file, int size)
+		{
+			using (FileStream s = File.OpenRead (file))
+				return LoadAtSize (s, size);
+		}
+
+		public static Pixbuf LoadAtSize (Stream s, int size)
+		{
+			PixbufLoader loader = NewLoader (size);
+
+			byte [] buf = new byte [ChunkSize];
+			int n;
+
+			while ((n = s.Read (buf, 0, buf.Length)) > 0) {
+				byte [] chunk = buf;
+
+				if (n < buf.Length) {
+					chunk = new byte [n];
+					Array.Copy (buf, chunk, n);
+				}
+
+				loader.Write (chunk);
+			}
+
+			loader.Close ();
+
+			return loader.Pixbuf;
+		}
+
+		public static Pixbuf LoadAtSize (byte [] data, int size)
+		{
+			PixbufLoader loader = NewLoader (size);
+
+			loader.Write (data);
+			loader.Close ();
+
+			return loader.Pixbuf;
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: NewLoader
+		private static PixbufLoader NewLoader (int size)
+		{
+			PixbufLoader loader = new PixbufLoader ();
+
+			new SizeHint (loader, size);
+
+			return loader;
+		}
+
+		// Internal Classes
+		// Internal Classes :: SizeHint
+		private class SizeHint
+		{
+			// Variables
+			private int size;
+
+			// Constructor
+			public SizeHint (PixbufLoader loader, int size)
+			{
+				this.size = size;
+
+				loader.SizePrepared += new SizePreparedHandler (OnSizePrepared);
+			}
+
+			// Handlers
+			// Handlers :: OnSizePrepared
+			private void OnSizePrepared (object o, SizePreparedArgs args)
+			{
+				int width  = args.Width;
+				int height = args.Height;
+
+				if (width <= size && height <= size)
+					return;
+
+				double size_d = (double) size;
+
+				if (height > width) {
+					width  = (int) Math.Round (size_d * width / height);
+					height = size;
+
+				} else {
+					height = (int) Math.Round (size_d * height / width);
+					width  = size;
+				}
+
+				((PixbufLoader) o).SetSize (Math.Max (width, 1), Math.Max (height, 1));
+			}
+		}
+	}
+}
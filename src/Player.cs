@@ -52,9 +52,10 @@ namespace Muine
 		public event         InvalidSongHandler InvalidSong;
 
 		// Callbacks
-		private SignalUtils.SignalDelegateInt tick_cb ;
-		private SignalUtils.SignalDelegate    eos_cb  ;
-		private SignalUtils.SignalDelegateStr error_cb;
+		private SignalUtils.SignalDelegateInt tick_cb    ;
+		private SignalUtils.SignalDelegate    eos_cb     ;
+		private SignalUtils.SignalDelegateStr error_cb   ;
+		private SignalUtils.SignalDelegateInt starving_cb;
 
 		// Objects
 		private Song song = null;
@@ -77,13 +78,15 @@ namespace Muine
 			if (error_ptr != IntPtr.Zero)
 				throw new PlayerException (error_ptr);
 			
-			tick_cb  = new SignalUtils.SignalDelegateInt (OnTick       );
-			eos_cb   = new SignalUtils.SignalDelegate    (OnEndOfStream);
-			error_cb = new SignalUtils.SignalDelegateStr (OnError      );
+			tick_cb     = new SignalUtils.SignalDelegateInt (OnTick       );
+			eos_cb      = new SignalUtils.SignalDelegate    (OnEndOfStream);
+			error_cb    = new SignalUtils.SignalDelegateStr (OnError      );
+			starving_cb = new SignalUtils.SignalDelegateInt (OnStarving   );
 
-			SignalUtils.SignalConnect (Raw, "tick"         , tick_cb );
-			SignalUtils.SignalConnect (Raw, "end_of_stream", eos_cb  );
-			SignalUtils.SignalConnect (Raw, "error"        , error_cb);
+			SignalUtils.SignalConnect (Raw, "tick"         , tick_cb    );
+			SignalUtils.SignalConnect (Raw, "end_of_stream", eos_cb     );
+			SignalUtils.SignalConnect (Raw, "error"        , error_cb   );
+			SignalUtils.SignalConnect (Raw, "starving"     , starving_cb);
 
 			playing = false;
 			song = null;
@@ -111,6 +114,9 @@ namespace Muine
 				
 				song = value;
 
+				// Keep imports off the disk while it's opened
+				ImportScheduler.TrackChanging ();
+
 				if (playing)
 					player_pause (Raw);
 
@@ -268,5 +274,11 @@ namespace Muine
 		{
 			new ErrorDialog (Global.Playlist, string_audio_error, error);
 		}
+
+		// Handlers :: OnStarving
+		private void OnStarving (IntPtr obj, int starving)
+		{
+			ImportScheduler.SetStarving (starving != 0);
+		}
 	}
 }
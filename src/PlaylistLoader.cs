@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2005, 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+using System.IO;
+
+using Gtk;
+using Gnome.Vfs;
+
+using Mono.Unix;
+
+namespace Muine
+{
+	/// <summary>
+	///	Reads and resolves a playlist on a thread, handing the
+	///	songs to the main loop in batches, in playlist order.
+	/// </summary>
+	/// <remarks>
+	///	Songs which aren't in the database yet are read on an
+	///	<see cref="ImportPipeline" />, so their tags are parsed
+	///	in parallel.
+	/// </remarks>
+	public class PlaylistLoader : ThreadBase
+	{
+		// Constants
+		// Constants :: ProgressDelay
+		//	Milliseconds after which to show the progress window
+		private const int ProgressDelay = 500;
+
+		// Strings
+		private static readonly string string_error_read =
+			Catalog.GetString ("Failed to read {0}:");
+
+		// Delegates
+		public delegate void ForeachFunc
+		  (Song song, bool playing, object user_data);
+
+		// Events
+		// Events :: BatchLoaded
+		public delegate void BatchLoadedHandler (PlaylistLoader loader);
+		public event         BatchLoadedHandler  BatchLoaded;
+
+		// Events :: Done
+		public delegate void DoneHandler (PlaylistLoader loader);
+		public event         DoneHandler  Done;
+
+		// Objects
+		private Window parent;
+		private ProgressWindow pw = null;
+		private ForeachFunc func;
+		private object user_data;
+
+		//	Entries submitted to the pipeline, in playlist order
+		private Queue entries = new Queue ();
+
+		// Variables
+		private string filename;
+		private string error = null;
+		private bool canceled = false;
+		private int n_loaded = 0;
+		private Song last_song = null;
+		private DateTime start_time;
+
+		// Constructor
+		/// <summary>
+		///	Start loading the playlist <paramref name="fn" />.
+		/// </summary>
+		/// <remarks>
+		///	<paramref name="func" /> is called from the main loop
+		///	for every song, in playlist order.
+		/// </remarks>
+		public PlaylistLoader
+		  (string fn, Window parent, ForeachFunc func, object user_data)
+		{
+			this.filename  = fn;
+			this.parent    = parent;
+			this.func      = func;
+			this.user_data = user_data;
+
+			start_time = DateTime.Now;
+
+			thread.Start ();
+		}
+
+		// Properties
+		// Properties :: Filename (get;)
+		public string Filename {
+			get { return filename; }
+		}
+
+		// Properties :: Canceled (get;)
+		/// <summary>
+		///	Whether loading was stopped before the end, with
+		///	<see cref="Cancel" /> or from the progress window.
+		/// </summary>
+		public bool Canceled {
+			get { return canceled; }
+		}
+
+		// Properties :: NLoaded (get;)
+		/// <summary>
+		///	The number of songs handed to the main loop so far.
+		/// </summary>
+		public int NLoaded {
+			get { return n_loaded; }
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Cancel
+		/// <summary>
+		///	Stop loading. No more songs will be handed out.
+		///	<see cref="Done" /> is still emitted, with
+		///	<see cref="Canceled" /> set.
+		/// </summary>
+		public void Cancel ()
+		{
+			canceled = true;
+		}
+
+		// Methods :: Protected
+		// Methods :: Protected :: HandleItem (ThreadBase)
+		protected override void HandleItem (object item)
+		{
+			if (canceled)
+				return;
+
+			Entry entry = (Entry) item;
+			Song song = entry.Song;
+
+			if (entry.New) {
+				Global.DB.AddSong (song);
+
+				// Someone else may have added it meanwhile
+				Song existing = Global.DB.GetSong (song.Filename);
+				if (existing != null)
+					song = existing;
+			}
+
+			func (song, entry.Playing, user_data);
+			n_loaded ++;
+			last_song = song;
+		}
+
+		// Methods :: Protected :: BatchFinished (ThreadBase)
+		protected override void BatchFinished ()
+		{
+			if (canceled) {
+				Finish ();
+				return;
+			}
+
+			if (BatchLoaded != null)
+				BatchLoaded (this);
+
+			// Report progress, if loading takes a while
+			if (pw == null && !thread_done) {
+				TimeSpan elapsed = DateTime.Now - start_time;
+				if (elapsed.TotalMilliseconds > ProgressDelay)
+					pw = new ProgressWindow (parent);
+			}
+
+			if (pw == null)
+				return;
+
+			string name = Path.GetFileName (filename);
+			string file = String.Format ("{0} ({1})",
+				Path.GetFileName (last_song.Filename), n_loaded);
+
+			if (pw.Report (name, file)) {
+				canceled = true;
+				Finish ();
+			}
+		}
+
+		// Methods :: Protected :: Finished (ThreadBase)
+		protected override void Finished ()
+		{
+			Finish ();
+
+			if (!canceled && error != null) {
+				string fn_readable = FileUtils.MakeHumanReadable (filename);
+				string msg = String.Format (string_error_read, fn_readable);
+				new ErrorDialog (parent, msg, error);
+			}
+
+			if (Done != null)
+				Done (this);
+		}
+
+		// Delegate Functions
+		// Delegate Functions :: ThreadFunc (ThreadBase)
+		protected override void ThreadFunc ()
+		{
+			VfsStream stream;
+			StreamReader reader;
+
+			try {
+				stream = new VfsStream (filename, System.IO.FileMode.Open);
+				reader = new StreamReader (stream);
+
+			} catch (Exception e) {
+				error = e.Message;
+				return;
+			}
+
+			ImportPipeline pipeline = new ImportPipeline
+			  (new ImportPipeline.CommitFunc (CommitFunc), null);
+
+			pipeline.Start ();
+
+			string line = null;
+
+			bool playing_song = false;
+
+			while (!canceled && (line = reader.ReadLine ()) != null) {
+				if (line.Length == 0)
+					continue;
+
+				if (line.StartsWith ("#")) {
+					if (line == "# PLAYING")
+						playing_song = true;
+
+					continue;
+				}
+
+				// DOS-to-UNIX
+				line = line.Replace ('\\', '/');
+
+				// Skip lines that aren't valid paths
+				try {
+					System.IO.Path.GetFileName (line);
+
+				} catch {
+					continue;
+				}
+
+				// Get Song
+				Song song = Global.DB.GetSong (line);
+
+				// If that didn't work, try harder...
+				if (song == null)
+					song = Global.DB.GetSongByBasename (line);
+
+				// If we don't have it in our Database, the pipeline
+				// reads it. Entries it can't read are skipped.
+				lock (entries)
+					entries.Enqueue (new Entry (line, playing_song, song == null));
+
+				playing_song = false;
+
+				if (!pipeline.Submit (line, song))
+					break;
+			}
+
+			if (canceled)
+				pipeline.Cancel ();
+
+			pipeline.Finish ();
+
+			// Close File
+			try {
+				reader.Close ();
+
+			} catch {
+			}
+		}
+
+		// Delegate Functions :: CommitFunc (ImportPipeline)
+		//	Called in playlist order, but not for skipped entries
+		private void CommitFunc (string filename, Song song)
+		{
+			Entry entry;
+
+			lock (entries) {
+				do {
+					entry = (Entry) entries.Dequeue ();
+				} while (entry.Filename != filename);
+			}
+
+			entry.Song = song;
+
+			Enqueue (entry);
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: Finish
+		private void Finish ()
+		{
+			if (pw == null)
+				return;
+
+			pw.Done ();
+			pw = null;
+		}
+
+		// Internal Classes
+		// Internal Classes :: Entry
+		private class Entry
+		{
+			public string Filename;
+			public Song   Song = null;
+			public bool   Playing;
+			public bool   New;
+
+			// Constructor
+			public Entry (string filename, bool playing, bool is_new)
+			{
+				Filename = filename;
+				Playing  = playing;
+				New      = is_new;
+			}
+		}
+	}
+}
@@ -129,9 +129,6 @@ namespace Muine
 		private static readonly string string_error_audio =
 			Catalog.GetString ("Failed to initialize the audio backend");
 
-		private static readonly string string_error_read =
-			Catalog.GetString ("Failed to read {0}:");
-
 		private static readonly string string_error_close =
 			Catalog.GetString ("Failed to close {0}:");
 
@@ -157,10 +154,6 @@ namespace Muine
 		// Events :: WatchedFoldersChangedEvent (IPlayer)
 		public event GenericEventHandler WatchedFoldersChangedEvent;
 
-		// Delegates
-		private delegate void PlaylistForeachFunc
-		  (Song song, bool playing, object user_data);
-
 		// Widgets
 		[Glade.Widget] private VBox           main_vbox     ;
 		[Glade.Widget] private Box            menu_bar_box  ;
@@ -206,6 +199,12 @@ namespace Muine
 		private bool had_last_eos;
 		private bool ignore_song_change;
 
+		// Objects :: PlaylistLoader
+		private PlaylistLoader playlist_loader = null;
+		private Queue playlist_loads = new Queue ();
+		private bool ensure_playing_while_loading;
+		private bool play_when_loaded;
+
 		// Drag-and-Drop
 		private static TargetEntry [] drag_entries = {
 			DndUtils.TargetUriList
@@ -234,6 +233,9 @@ namespace Muine
 
 		private Hashtable random_sort_keys;
 
+		private ISong [] playlist_snapshot = null;
+		private uint playlist_snapshot_version;
+
 		private bool repeat;
 
 		// Constructor
@@ -271,8 +273,8 @@ namespace Muine
 			SetupPlaylist ();
 
 			// Connect to song database signals
-			Global.DB.SongChanged           += OnSongChanged;
-			Global.DB.SongRemoved           += OnSongRemoved;
+			Global.DB.SongsChanged          += OnSongsChanged;
+			Global.DB.SongsRemoved          += OnSongsRemoved;
 			Global.DB.WatchedFoldersChanged += OnWatchedFoldersChanged;
 
 			// Make sure the interface is up to date
@@ -347,8 +349,29 @@ namespace Muine
 		}
 
 		// Properties :: Playlist (get;) (IPlayer)
+		//	The array is shared between all callers until the
+		//	playlist changes, so plugins must not modify it.
 		public ISong [] Playlist {
-			get { return ArrayFromList (playlist.Model.Contents); }
+			get {
+				uint version = playlist.Model.Version;
+
+				if (playlist_snapshot == null ||
+				    playlist_snapshot_version != version) {
+					playlist_snapshot =
+					  ArrayFromHandles (playlist.Model.Snapshot);
+
+					playlist_snapshot_version = version;
+				}
+
+				return playlist_snapshot;
+			}
+		}
+
+		// Properties :: PlaylistVersion (get;) (IPlayer)
+		//	Changes whenever songs are added to, removed from or
+		//	moved within the playlist.
+		public uint PlaylistVersion {
+			get { return playlist.Model.Version; }
 		}
 
 		// Properties :: Selection (get;) (IPlayer)
@@ -438,10 +461,11 @@ namespace Muine
 			if (!System.IO.File.Exists (FileUtils.PlaylistFile))
 				return;
 
+			// The playing song is marked in the file, so don't pick
+			// the first one while we're still looking for it
 			OpenPlaylistInternal (FileUtils.PlaylistFile,
-				new PlaylistForeachFunc (RestorePlaylistForeachFunc), null);
-
-			EnsurePlaying ();
+				new PlaylistLoader.ForeachFunc (RestorePlaylistForeachFunc),
+				null, false);
 		}
 
 		// Methods :: Public :: Run
@@ -512,17 +536,16 @@ namespace Muine
 		// Methods :: Public :: OpenPlaylist (IPlayer)
 		public void OpenPlaylist (string fn)
 		{
-			BusyLevel ++;
-
 			ClearPlaylist ();
+
 			OpenPlaylistInternal (fn,
-				new PlaylistForeachFunc (RegularPlaylistForeachFunc), null);
+				new PlaylistLoader.ForeachFunc (RegularPlaylistForeachFunc),
+				null, true);
 
-			EnsurePlaying ();
 			PlaylistChanged ();
-			Playing = true;
 
-			BusyLevel --;
+			// Start playing as soon as the first songs come in
+			play_when_loaded = true;
 		}
 
 		// Methods :: Public :: Previous (IPlayer)
@@ -658,6 +681,33 @@ namespace Muine
 			Global.DB.RemoveSong ((Song) song);
 		}
 
+		// Methods :: Public :: MoveSong (IPlayer)
+		public void MoveSong (string old_path, string new_path)
+		{
+			Song song;
+			lock (Global.DB)
+				song = (Song) Global.DB.Songs [old_path];
+
+			// Not ours, or not music anymore
+			if (song == null) {
+				AddSong (new_path);
+				return;
+			}
+
+			if (!DirectoryWalker.IsMusicFile (new_path)) {
+				Global.DB.RemoveSong (song);
+				return;
+			}
+
+			Global.DB.MoveSong (song, new_path);
+		}
+
+		// Methods :: Public :: MoveFolder (IPlayer)
+		public void MoveFolder (string old_folder, string new_folder)
+		{
+			Global.DB.MoveFolder (old_folder, new_folder);
+		}
+
 		// Methods :: Public :: AddFolder (IPlayer)
 		public void AddFolder (string folder)
 		{
@@ -704,36 +754,20 @@ namespace Muine
 		{
 			List selected_pointers = playlist.SelectedHandles;
 
-			int counter = 0;
-			int selected_pointers_count = selected_pointers.Count;
-			bool song_changed = false;
-
-			// HACK: To improve performance, only load new song once
-			ignore_song_change = true; 
-
-			foreach (int i in selected_pointers) {
-				IntPtr sel = new IntPtr (i);
-
-				if (sel == playlist.Model.Playing) {
-					OnPlayingSongRemoved ();		
-					song_changed = true;
-				}
-				
-				if (counter == selected_pointers_count - 1) {
-					bool go_next = playlist.SelectNext ();
-					if (!go_next)
-						playlist.SelectPrevious ();
-				}
+			if (selected_pointers.Count == 0)
+				return;
 
-				RemoveSong (sel);
+			IntPtr [] handles = new IntPtr [selected_pointers.Count];
 
-				counter ++;
-			}
+			for (int i = 0; i < handles.Length; i++)
+				handles [i] = new IntPtr ((int) selected_pointers [i]);
 
-			ignore_song_change = false;
+			// Move the selection off the rows that are going away
+			bool go_next = playlist.SelectNext ();
+			if (!go_next)
+				playlist.SelectPrevious ();
 
-			if (song_changed)
-				SongChanged (true);
+			RemoveSongs (handles);
 
 			PlaylistChanged ();
 		}
@@ -749,14 +783,13 @@ namespace Muine
 				return;
 			}
 
-			foreach (int i in playlist.Model.Contents) {
-				IntPtr current = new IntPtr (i);
+			IntPtr [] snapshot = playlist.Model.Snapshot;
+			int n_played = Array.IndexOf (snapshot, playlist.Model.Playing);
 
-				if (current == playlist.Model.Playing)
-					break;
+			IntPtr [] played = new IntPtr [n_played];
+			Array.Copy (snapshot, played, n_played);
 
-				RemoveSong (current);
-			}
+			RemoveSongs (played);
 
 			playlist.Select (playlist.Model.Playing);
 			PlaylistChanged ();
@@ -777,10 +810,11 @@ namespace Muine
 
 			random_sort_keys = new Hashtable ();
 
-			foreach (int i in playlist.Model.Contents) {
-				int playing_i = (int) playlist.Model.Playing;
-				double val = (i == playing_i) ? -1.0 : rand.NextDouble ();
-				random_sort_keys.Add (i, val);
+			IntPtr playing = playlist.Model.Playing;
+
+			foreach (IntPtr p in playlist.Model.Snapshot) {
+				double val = (p == playing) ? -1.0 : rand.NextDouble ();
+				random_sort_keys.Add ((int) p, val);
 			}
 
 			playlist.Model.Sort (new HandleModel.CompareFunc (ShuffleFunc));
@@ -827,18 +861,18 @@ namespace Muine
 			// Write
 			if (!(exclude_played && had_last_eos)) {
 				bool had_playing_song = false;
-				foreach (int i in playlist.Model.Contents) {
-					IntPtr ptr = new IntPtr (i);
+				IntPtr playing = playlist.Model.Playing;
 
+				foreach (IntPtr ptr in playlist.Model.Snapshot) {
 					if (exclude_played) {
-						if (ptr == playlist.Model.Playing)
+						if (ptr == playing)
 							had_playing_song = true;
 
 						else if (!had_playing_song)
 							continue;
 					}
 				
-					if (store_playing && ptr == playlist.Model.Playing)
+					if (store_playing && ptr == playing)
 						writer.WriteLine ("# PLAYING");
 
 					Song song = Song.FromHandle (ptr);
@@ -1057,6 +1091,32 @@ namespace Muine
 				song.UnregisterExtraHandle (p);
 		}
 
+		// Methods :: Private :: RemoveSongs
+		private void RemoveSongs (IntPtr [] handles)
+		{
+			// HACK: To improve performance, only load new song once
+			ignore_song_change = true;
+
+			bool playing_changed = playlist.Model.RemoveHandles (handles);
+
+			ignore_song_change = false;
+
+			foreach (IntPtr p in handles) {
+				Song song = Song.FromHandle (p);
+
+				if (song.IsExtraHandle (p))
+					song.UnregisterExtraHandle (p);
+			}
+
+			if (!playing_changed)
+				return;
+
+			if (playlist.Model.Playing == IntPtr.Zero)
+				player.Stop ();
+
+			SongChanged (true);
+		}
+
 		// Methods :: Private :: UpdateTimeLabels
 		private void UpdateTimeLabels (int time)
 		{
@@ -1147,15 +1207,15 @@ namespace Muine
 			
 			remaining_songs_time = 0;
 
-			foreach (int i in playlist.Model.Contents) {
-				IntPtr current = new IntPtr (i);
+			IntPtr playing = playlist.Model.Playing;
 
+			foreach (IntPtr current in playlist.Model.Snapshot) {
 				if (start_counting) {
 					Song song = Song.FromHandle (current);
 					remaining_songs_time += song.Duration;
 				}
 					
-				if (current != playlist.Model.Playing)
+				if (current != playing)
 					continue;
 
 				start_counting = true;
@@ -1180,7 +1240,10 @@ namespace Muine
 
 			UpdateTimeLabels (player.Position);
 
-			SavePlaylist (FileUtils.PlaylistFile, !repeat, true);
+			// Don't overwrite the stored playlist with a partial one,
+			// it may well be the one we're still reading
+			if (playlist_loader == null && playlist_loads.Count == 0)
+				SavePlaylist (FileUtils.PlaylistFile, !repeat, true);
 
 			// Run PlaylistChangedEvent Handlers
 			if (PlaylistChangedEvent != null)
@@ -1297,6 +1360,8 @@ namespace Muine
 		// Methods :: Private :: ClearPlaylist
 		private void ClearPlaylist ()
 		{
+			CancelPlaylistLoad ();
+
 			playlist.Model.Clear ();
 			player.Stop ();
 		}
@@ -1318,92 +1383,72 @@ namespace Muine
 		}
 
 		// Methods :: Private :: OpenPlaylistInternal
+		//	Only one playlist is loaded at a time, the others wait
+		//	their turn.
 		private void OpenPlaylistInternal
-		  (string fn, PlaylistForeachFunc func, object user_data)
+		  (string fn, PlaylistLoader.ForeachFunc func, object user_data,
+		   bool ensure_playing)
 		{
-			VfsStream stream;
-			StreamReader reader;
+			playlist_loads.Enqueue
+			  (new PlaylistLoad (fn, null, func, user_data, ensure_playing));
 
-			try {
-				stream = new VfsStream (fn, System.IO.FileMode.Open);
-				reader = new StreamReader (stream);
-
-			} catch (Exception e) {
-				string fn_readable = FileUtils.MakeHumanReadable (fn);
-				string msg = String.Format (string_error_read, fn_readable);
-				new ErrorDialog (this, msg, e.Message);
-				return;
-			}
+			StartPlaylistLoad ();
+		}
 
-			string line = null;
+		// Methods :: Private :: QueueDragSongs
+		//	Adds songs from a drop after the playlists dropped
+		//	before them.
+		private void QueueDragSongs (ArrayList songs, DragAddSongPosition pos)
+		{
+			Song [] array = (Song []) songs.ToArray (typeof (Song));
 
-			bool playing_song = false;
+			playlist_loads.Enqueue (new PlaylistLoad (null, array,
+				new PlaylistLoader.ForeachFunc (DragPlaylistForeachFunc),
+				pos, true));
 
-			while ((line = reader.ReadLine ()) != null) {
-				if (line.Length == 0)
-					continue;
-
-				if (line.StartsWith ("#")) {
-					if (line == "# PLAYING")
-						playing_song = true;
+			StartPlaylistLoad ();
+		}
 
-					continue;
-				}
+		// Methods :: Private :: StartPlaylistLoad
+		//	Starts the next queued load, if none is running.
+		private void StartPlaylistLoad ()
+		{
+			while (playlist_loader == null && playlist_loads.Count > 0) {
+				PlaylistLoad load = (PlaylistLoad) playlist_loads.Dequeue ();
 
-				// DOS-to-UNIX
-				line.Replace ('\\', '/');
+				ensure_playing_while_loading = load.EnsurePlaying;
 
-				string basename = String.Empty;
+				if (load.Songs == null) {
+					playlist_loader = new PlaylistLoader
+					  (load.Filename, this, load.Func, load.UserData);
 
-				try {
-					basename = System.IO.Path.GetFileName (line);
+					playlist_loader.BatchLoaded += OnPlaylistBatchLoaded;
+					playlist_loader.Done        += OnPlaylistLoadDone;
 
-				} catch {
 					continue;
 				}
 
-				// Get Song
-				Song song = Global.DB.GetSong (line);
-				
-				// If that didn't work, try harder...
-				if (song == null) { 
-					lock (Global.DB) {
-						foreach (string key in Global.DB.Songs.Keys) {
-							string key_basename =
-							  System.IO.Path.GetFileName (key);
-
-							if (basename != key_basename)
-								continue;
-
-							song = Global.DB.GetSong (key);
-							break;
-						}
-					}
-				}
-
-				// If we don't have it in our Database, try adding it.
-				if (song == null)
-					song = AddSongToDB (line);
-
-				// Give up if we don't have the song by now.
-				if (song == null)
-					return; 
+				foreach (Song song in load.Songs)
+					load.Func (song, false, load.UserData);
 
-				// Add song (and play) 
-				func (song, playing_song, user_data);
-				playing_song = false;
+				if (load.EnsurePlaying)
+					EnsurePlaying ();
 			}
+		}
 
-			// Close File
-			try {
-				reader.Close ();
+		// Methods :: Private :: CancelPlaylistLoad
+		//	Cancels the running load and those waiting.
+		private void CancelPlaylistLoad ()
+		{
+			playlist_loads.Clear ();
 
-			} catch (Exception e) {
-				string fn_readable = FileUtils.MakeHumanReadable (fn);
-				string msg = String.Format (string_error_close, fn_readable);
-				new ErrorDialog (this, msg, e.Message);
+			if (playlist_loader == null)
 				return;
-			}
+
+			playlist_loader.Cancel ();
+			playlist_loader = null;
+
+			play_when_loaded = false;
 		}
 
 		// Methods :: Private :: AddSongToDB
@@ -1506,6 +1551,17 @@ namespace Muine
 			return array;
 		}
 
+		// Methods :: Private :: ArrayFromHandles
+		private ISong [] ArrayFromHandles (IntPtr [] handles)
+		{
+			ISong [] array = new ISong [handles.Length];
+
+			for (int i = 0; i < handles.Length; i++)
+				array [i] = Song.FromHandle (handles [i]);
+
+			return array;
+		}
+
 		// Methods :: Private :: RestoreState
 		private void RestoreState ()
 		{
@@ -1830,76 +1886,100 @@ namespace Muine
 			SongChanged (true);
 		}
 
-		// Handlers :: OnSongChanged
-		private void OnSongChanged (Song song)
+		// Handlers :: OnSongsChanged
+		private void OnSongsChanged (Song [] songs)
 		{
-			bool song_changed = false;
-			foreach (IntPtr h in song.Handles) {
-				if (!playlist.Model.Contains (h))
-					continue;
+			bool songs_changed = false;
+			bool playing_changed = false;
 
-				song_changed = true;
-				
-				// Use overload of SongChanged that won't fire the
-				// "SongChanged" event, since we really only want to update
-				// the pixbuf, labels, etc.
-				if (h == playlist.Model.Playing)
-					SongChanged (false, false);
+			foreach (Song song in songs) {
+				foreach (IntPtr h in song.Handles) {
+					if (!playlist.Model.Contains (h))
+						continue;
+
+					songs_changed = true;
 
-				playlist.Model.Changed (h);
+					if (h == playlist.Model.Playing)
+						playing_changed = true;
+
+					playlist.Model.Changed (h);
+				}
 			}
 			
-			if (!song_changed)
+			if (!songs_changed)
 				return;
 
+			// Use overload of SongChanged that won't fire the
+			// "SongChanged" event, since we really only want to update
+			// the pixbuf, labels, etc.
+			if (playing_changed)
+				SongChanged (false, false);
+
 			PlaylistChanged ();
 		}
 
-		// Handlers :: OnPlayingSongRemoved
-		private void OnPlayingSongRemoved ()
+		// Handlers :: OnSongsRemoved
+		private void OnSongsRemoved (Song [] songs)
 		{
-			// Try going forward
-			if (playlist.Model.HasNext) {
-				playlist.Model.Next ();
-				return;
+			ArrayList removed = new ArrayList ();
+			
+			foreach (Song song in songs) {
+				foreach (IntPtr h in song.Handles) {
+					if (playlist.Model.Contains (h))
+						removed.Add (h);
+				}
 			}
-
-			// Try going backwards
-			if (playlist.Model.HasPrevious) {
-				playlist.Model.Previous ();
+			
+			if (removed.Count == 0)
 				return;
+
+			// Move a single selection off the rows that are going away
+			if (playlist.Selection.CountSelectedRows () == 1) {
+				IntPtr selected =
+				  new IntPtr ((int) playlist.SelectedHandles [0]);
+
+				if (removed.Contains (selected) && !playlist.SelectNext ())
+					playlist.SelectPrevious ();
 			}
 
-			// Playlist must be empty
-			playlist.Model.Playing = IntPtr.Zero;
-			player.Stop ();
+			Type ptr_type = typeof (IntPtr);
+			RemoveSongs ((IntPtr []) removed.ToArray (ptr_type));
+
+			PlaylistChanged ();
 		}
 
-		// Handlers :: OnSongRemoved
-		private void OnSongRemoved (Song song)
+		// Handlers :: OnPlaylistBatchLoaded
+		private void OnPlaylistBatchLoaded (PlaylistLoader loader)
 		{
-			bool n_songs_changed = false;
-			
-			foreach (IntPtr h in song.Handles) {
-				if (!playlist.Model.Contains (h))
-					continue;
+			if (loader != playlist_loader)
+				return;
 
-				n_songs_changed = true;
-				
-				if (h == playlist.Model.Playing)
-					OnPlayingSongRemoved ();
+			if (ensure_playing_while_loading)
+				EnsurePlaying ();
 
-				if ((playlist.Selection.CountSelectedRows () == 1) &&
-				    ((int) playlist.SelectedHandles [0] == (int) h &&
-				    !playlist.SelectNext ()))
-					playlist.SelectPrevious ();
+			PlaylistChanged ();
 
-				playlist.Model.Remove (h);
-			}
-			
-			if (!n_songs_changed)
+			if (!play_when_loaded || !playlist.Model.HasFirst)
 				return;
 
+			play_when_loaded = false;
+			Playing = true;
+		}
+
+		// Handlers :: OnPlaylistLoadDone
+		private void OnPlaylistLoadDone (PlaylistLoader loader)
+		{
+			if (loader != playlist_loader)
+				return;
+
+			playlist_loader = null;
+			play_when_loaded = false;
+
+			EnsurePlaying ();
+
+			StartPlaylistLoad ();
+
+			// Now store the complete playlist
 			PlaylistChanged ();
 		}
 
@@ -2092,6 +2172,11 @@ namespace Muine
 
 				ArrayList new_dinfos = new ArrayList ();
 
+				// Songs after a playlist wait for it, to keep
+				// the order of the drop
+				bool queueing = false;
+				ArrayList queued_songs = new ArrayList ();
+
 				foreach (string s in bits) {
 					string fn = Gnome.Vfs.Uri.GetLocalPathFromUri (s);
 
@@ -2111,27 +2196,39 @@ namespace Muine
 						continue;
 						
 					if (FileUtils.IsPlaylist (fn)) {
-						BusyLevel ++;
+						if (queued_songs.Count > 0) {
+							QueueDragSongs (queued_songs, pos);
+							queued_songs.Clear ();
+						}
 
 						OpenPlaylistInternal (fn,
-							new PlaylistForeachFunc (DragPlaylistForeachFunc),
-							pos);
+							new PlaylistLoader.ForeachFunc (DragPlaylistForeachFunc),
+							pos, true);
 
-						BusyLevel --;
-
-						added_files = true;
+						queueing = true;
+						success = true;
 						
 						continue;
 					}
 
 					Song song = GetSingleSong (finfo.FullName, false);
 						
-					if (song != null) {
+					if (song == null)
+						continue;
+
+					if (queueing) {
+						queued_songs.Add (song);
+						success = true;
+
+					} else {
 						DragAddSong (song, pos);
 						added_files = true;
 					}
 				}
 
+				if (queued_songs.Count > 0)
+					QueueDragSongs (queued_songs, pos);
+
 				if (added_files) {
 					EnsurePlaying ();
 					PlaylistChanged ();
@@ -2315,6 +2412,12 @@ namespace Muine
 		  (Song song, bool playing, object user_data)
 		{
 			DragAddSongPosition pos = (DragAddSongPosition) user_data;
+
+			// The row may have been removed while we were loading
+			if (pos.Pointer != IntPtr.Zero &&
+			    !playlist.Model.Contains (pos.Pointer))
+				pos.Pointer = IntPtr.Zero;
+
 			DragAddSong (song, pos);
 		}
 
@@ -2347,5 +2450,29 @@ namespace Muine
 			public TreeViewDropPosition Position;
 			public bool                 First   ;
 		}
+
+		// Internal Classes :: PlaylistLoad
+		//	A playlist file, or songs from a drop, waiting to be
+		//	added.
+		private class PlaylistLoad
+		{
+			public string                     Filename     ;
+			public Song []                    Songs        ;
+			public PlaylistLoader.ForeachFunc Func         ;
+			public object                     UserData     ;
+			public bool                       EnsurePlaying;
+
+			// Constructor
+			public PlaylistLoad (string fn, Song [] songs,
+			  PlaylistLoader.ForeachFunc func, object user_data,
+			  bool ensure_playing)
+			{
+				Filename      = fn;
+				Songs         = songs;
+				Func          = func;
+				UserData      = user_data;
+				EnsurePlaying = ensure_playing;
+			}
+		}
 	}
 }
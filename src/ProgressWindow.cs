@@ -35,11 +35,18 @@ namespace Muine
 		private static readonly string string_loading =
 			Catalog.GetString ("Loading:");
 
+		private static readonly string string_rate =
+			Catalog.GetString ("{0:0} files per second, {1} waiting to be read, {2} to be added");
+
+		private static readonly string string_eta =
+			Catalog.GetString ("About {0} left in this folder");
+
 
 		// Widgets
 		[Glade.Widget] private Window window;
 		[Glade.Widget] private Label  loading_label;
 		[Glade.Widget] private Label  file_label;
+		[Glade.Widget] private Label  stats_label;
 
 		// Variables
 		private bool canceled = false;
@@ -85,6 +92,44 @@ namespace Muine
 			return false;
 		}
 
+		// Methods :: Public :: ReportRate
+		/// <summary>
+		///	Show how fast files are imported, and how long the
+		///	ones found so far will take.
+		/// </summary>
+		/// <param name="n_folders_waiting">
+		///	The number of folders queued after the current one.
+		/// </param>
+		public void ReportRate
+		  (double files_per_second, int n_waiting_read, int n_waiting_add,
+		   int n_folders_waiting)
+		{
+			string text = String.Format (string_rate,
+				files_per_second, n_waiting_read, n_waiting_add);
+
+			if (files_per_second > 0) {
+				long seconds = (long) Math.Ceiling
+				  ((n_waiting_read + n_waiting_add) / files_per_second);
+
+				text += "\n" + String.Format (string_eta,
+					StringUtils.SecondsToString (seconds));
+			}
+
+			if (n_folders_waiting > 0) {
+				string string_folders = Catalog.GetPluralString (
+					"{0} more folder queued",
+					"{0} more folders queued",
+					n_folders_waiting);
+
+				text += "\n" + String.Format (string_folders,
+					n_folders_waiting);
+			}
+
+			stats_label.Text = text;
+
+			stats_label.Visible = true;
+		}
+
 		// Methods :: Public :: Done
 		public void Done ()
 		{
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+
+namespace Muine
+{
+	/// <summary>
+	///	Remembers the files below the watched folders which have
+	///	a music extension, but turned out not to be music.
+	/// </summary>
+	/// <remarks>
+	///	Files are remembered with their mtime and size, so one is
+	///	only skipped for as long as it hasn't changed.
+	/// </remarks>
+	public class RejectedFileDatabase
+	{
+		// Objects
+		private Database db;
+		private Hashtable entries;
+
+		// Variables
+		private bool loaded = false;
+
+		// Constructor
+		/// <summary>
+		///	Create a <see cref="RejectedFileDatabase" /> object.
+		/// </summary>
+		/// <param name="version">
+		///	Version of the database to use.
+		/// </param>
+		public RejectedFileDatabase (int version)
+		{
+			db = new Database (FileUtils.RejectedDBFile, version);
+
+			entries = new Hashtable ();
+		}
+
+		// Properties
+		// Properties :: Paths (get;)
+		/// <summary>
+		///	The files we know to be rejected.
+		/// </summary>
+		public string [] Paths {
+			get {
+				lock (this) {
+					string [] paths = new string [entries.Count];
+					entries.Keys.CopyTo (paths, 0);
+					return paths;
+				}
+			}
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Load
+		/// <summary>
+		///	Load the database, unless that was done already.
+		/// </summary>
+		public void Load ()
+		{
+			lock (this) {
+				if (loaded)
+					return;
+
+				db.Load (new Database.DecodeFunctionDelegate (DecodeFunction));
+				loaded = true;
+			}
+		}
+
+		// Methods :: Public :: Contains
+		/// <summary>
+		///	Whether <paramref name="path" /> was rejected, and
+		///	hasn't changed since.
+		/// </summary>
+		public bool Contains (string path, int mtime, long size)
+		{
+			lock (this) {
+				Entry entry = (Entry) entries [path];
+
+				return (entry != null &&
+					entry.MTime == mtime && entry.Size == size);
+			}
+		}
+
+		// Methods :: Public :: Add
+		public void Add (string path, int mtime, long size)
+		{
+			lock (this) {
+				Entry entry = new Entry (mtime, size);
+				entries [path] = entry;
+
+				int data_size;
+				IntPtr data = entry.Pack (out data_size);
+				db.Store (path, data, data_size, true);
+			}
+		}
+
+		// Methods :: Public :: Remove
+		public void Remove (string path)
+		{
+			lock (this) {
+				if (!entries.ContainsKey (path))
+					return;
+
+				entries.Remove (path);
+				db.Delete (path);
+			}
+		}
+
+		// Delegate Functions
+		// Delegate Functions :: DecodeFunction
+		private void DecodeFunction (string key, IntPtr data)
+		{
+			entries [key] = new Entry (data);
+		}
+
+		// Internal Classes
+		// Internal Classes :: Entry
+		private class Entry
+		{
+			public int  MTime;
+			public long Size;
+
+			// Constructor
+			public Entry (int mtime, long size)
+			{
+				MTime = mtime;
+				Size  = size;
+			}
+
+			public Entry (IntPtr data)
+			{
+				IntPtr p = data;
+
+				p = Database.UnpackInt  (p, out MTime);
+				p = Database.UnpackLong (p, out Size );
+			}
+
+			// Methods
+			// Methods :: Public
+			// Methods :: Public :: Pack
+			public IntPtr Pack (out int length)
+			{
+				IntPtr p;
+
+				p = Database.PackStart ();
+
+				Database.PackInt  (p, MTime);
+				Database.PackLong (p, Size );
+
+				return Database.PackEnd (p, out length);
+			}
+		}
+	}
+}
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+using System.IO;
+using System.Security.Cryptography;
+using System.Text;
+
+namespace Muine
+{
+	/// <summary>
+	///	Web responses kept on disk, so they don't have to be
+	///	fetched again.
+	/// </summary>
+	/// <remarks>
+	///	Every response is a file named after the SHA-1 of its key,
+	///	which is the query or URL it answers. When the files take
+	///	more than the budget, those used least recently are
+	///	deleted; a file's mtime is bumped when it's used.
+	/// </remarks>
+	public class ResponseCache
+	{
+		// Constants
+		private const string TempSuffix = ".tmp";
+
+		// Objects
+		//	File name => size
+		private Hashtable sizes = null;
+
+		// Variables
+		private string directory;
+		private long budget;
+		private long size = 0;
+
+		private int n_hits   = 0;
+		private int n_misses = 0;
+
+		// Constructor
+		/// <summary>
+		///	Create a new <see cref="ResponseCache" />.
+		/// </summary>
+		/// <param name="directory">
+		///	The directory to keep the responses in. It's created
+		///	when the first response is stored.
+		/// </param>
+		/// <param name="budget">
+		///	The number of bytes to keep at most.
+		/// </param>
+		public ResponseCache (string directory, long budget)
+		{
+			this.directory = directory;
+			this.budget = budget;
+		}
+
+		// Properties
+		// Properties :: NHits (get;)
+		public int NHits {
+			get { lock (this) return n_hits; }
+		}
+
+		// Properties :: NMisses (get;)
+		public int NMisses {
+			get { lock (this) return n_misses; }
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Get
+		/// <summary>
+		///	The response stored under <paramref name="key" />.
+		/// </summary>
+		/// <returns>
+		///	The response, or null if there is none.
+		/// </returns>
+		public byte [] Get (string key)
+		{
+			lock (this) {
+				Scan ();
+
+				string name = FileName (key);
+
+				if (!sizes.ContainsKey (name)) {
+					n_misses ++;
+					return null;
+				}
+
+				string path = Path.Combine (directory, name);
+
+				try {
+					byte [] data = File.ReadAllBytes (path);
+
+					File.SetLastWriteTimeUtc (path, DateTime.UtcNow);
+
+					n_hits ++;
+					return data;
+
+				} catch (Exception) {
+					Forget (name);
+
+					n_misses ++;
+					return null;
+				}
+			}
+		}
+
+		public string GetString (string key)
+		{
+			byte [] data = Get (key);
+
+			return (data != null) ? Encoding.UTF8.GetString (data) : null;
+		}
+
+		// Methods :: Public :: Put
+		/// <summary>
+		///	Store <paramref name="data" /> under
+		///	<paramref name="key" />, replacing what was there.
+		/// </summary>
+		/// <remarks>
+		///	Failing to write is not an error, the response just
+		///	isn't cached.
+		/// </remarks>
+		public void Put (string key, byte [] data)
+		{
+			if (data.LongLength > budget)
+				return;
+
+			lock (this) {
+				Scan ();
+
+				string name = FileName (key);
+				string path = Path.Combine (directory, name);
+				string temp_path = path + TempSuffix;
+
+				try {
+					Directory.CreateDirectory (directory);
+
+					File.WriteAllBytes (temp_path, data);
+
+					if (File.Exists (path))
+						File.Delete (path);
+
+					File.Move (temp_path, path);
+
+				} catch (Exception) {
+					return;
+				}
+
+				Forget (name);
+
+				sizes [name] = data.LongLength;
+				size += data.LongLength;
+
+				if (size > budget)
+					Evict ();
+			}
+		}
+
+		public void PutString (string key, string data)
+		{
+			Put (key, Encoding.UTF8.GetBytes (data));
+		}
+
+		// Methods :: Public :: Remove
+		public void Remove (string key)
+		{
+			lock (this) {
+				Scan ();
+
+				string name = FileName (key);
+
+				try {
+					File.Delete (Path.Combine (directory, name));
+				} catch (Exception) {
+				}
+
+				Forget (name);
+			}
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: FileName
+		private static string FileName (string key)
+		{
+			SHA1 sha = new SHA1CryptoServiceProvider ();
+			byte [] hash = sha.ComputeHash (Encoding.UTF8.GetBytes (key));
+
+			StringBuilder name = new StringBuilder (hash.Length * 2);
+			foreach (byte b in hash)
+				name.Append (b.ToString ("x2"));
+
+			return name.ToString ();
+		}
+
+		// Methods :: Private :: Scan
+		//	Finds the responses stored in earlier sessions. Call
+		//	with the lock held.
+		private void Scan ()
+		{
+			if (sizes != null)
+				return;
+
+			sizes = new Hashtable ();
+
+			if (!Directory.Exists (directory))
+				return;
+
+			foreach (FileInfo file in new DirectoryInfo (directory).GetFiles ()) {
+				// Left over from a crash
+				if (file.Name.EndsWith (TempSuffix)) {
+					try {
+						file.Delete ();
+					} catch (Exception) {
+					}
+
+					continue;
+				}
+
+				sizes [file.Name] = file.Length;
+				size += file.Length;
+			}
+		}
+
+		// Methods :: Private :: Forget
+		private void Forget (string name)
+		{
+			object old_size = sizes [name];
+			if (old_size == null)
+				return;
+
+			size -= (long) old_size;
+			sizes.Remove (name);
+		}
+
+		// Methods :: Private :: Evict
+		//	Deletes the least recently used responses until 10%
+		//	of the budget is free, so it doesn't happen on every
+		//	store. Call with the lock held.
+		private void Evict ()
+		{
+			FileInfo [] files;
+
+			try {
+				files = new DirectoryInfo (directory).GetFiles ();
+			} catch (Exception) {
+				return;
+			}
+
+			Array.Sort (files, new LeastRecentlyUsedFirst ());
+
+			long target = budget - budget / 10;
+
+			foreach (FileInfo file in files) {
+				if (size <= target)
+					break;
+
+				if (!sizes.ContainsKey (file.Name))
+					continue;
+
+				try {
+					file.Delete ();
+				} catch (Exception) {
+					continue;
+				}
+
+				Forget (file.Name);
+			}
+		}
+
+		// Internal Classes
+		// Internal Classes :: LeastRecentlyUsedFirst
+		private class LeastRecentlyUsedFirst : IComparer
+		{
+			// Methods
+			// Methods :: Compare (IComparer)
+			public int Compare (object a, object b)
+			{
+				FileInfo file_a = (FileInfo) a;
+				FileInfo file_b = (FileInfo) b;
+
+				return file_a.LastWriteTimeUtc.CompareTo (file_b.LastWriteTimeUtc);
+			}
+		}
+	}
+}
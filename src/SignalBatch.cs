@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+
+namespace Muine
+{
+	/// <summary>
+	///	The songs and albums collected for the batched events of
+	///	<see cref="SongDatabase" />, from BeginSignalBatch until
+	///	the outermost EndSignalBatch.
+	/// </summary>
+	/// <remarks>
+	///	Items that were removed are deregistered only after the
+	///	events were emitted, so handlers can still find them by
+	///	their handles. Changes to removed items aren't signalled,
+	///	and items that were added and removed in the same batch
+	///	aren't signalled at all.
+	/// </remarks>
+	public class SignalBatch
+	{
+		// Enums
+		// Enums :: Signal
+		//	In the order they are emitted
+		public enum Signal {
+			SongsAdded,
+			AlbumsAdded,
+			SongsChanged,
+			AlbumsChanged,
+			SongsRemoved,
+			AlbumsRemoved
+		}
+
+		// Delegates
+		public delegate void EmitFunction (Signal signal, Array items);
+
+		// Objects
+		private ItemSet songs_added    = new ItemSet ();
+		private ItemSet songs_changed  = new ItemSet ();
+		private ItemSet songs_removed  = new ItemSet ();
+		private ItemSet albums_added   = new ItemSet ();
+		private ItemSet albums_changed = new ItemSet ();
+		private ItemSet albums_removed = new ItemSet ();
+
+		//	Removed items, deregistered when the batch ends
+		private ArrayList dead = new ArrayList ();
+
+		// Variables
+		private Type song_type;
+		private Type album_type;
+
+		// Constructor
+		/// <param name="song_type">
+		///	The type of the arrays for the song events.
+		/// </param>
+		/// <param name="album_type">
+		///	The type of the arrays for the album events.
+		/// </param>
+		public SignalBatch (Type song_type, Type album_type)
+		{
+			this.song_type  = song_type;
+			this.album_type = album_type;
+		}
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: AddSong
+		public void AddSong (Item song)
+		{
+			songs_added.Add (song);
+		}
+
+		// Methods :: Public :: ChangeSong
+		public void ChangeSong (Item song)
+		{
+			songs_changed.Add (song);
+		}
+
+		// Methods :: Public :: RemoveSong
+		public void RemoveSong (Item song)
+		{
+			songs_removed.Add (song);
+		}
+
+		// Methods :: Public :: AddAlbum
+		public void AddAlbum (Item album)
+		{
+			albums_added.Add (album);
+		}
+
+		// Methods :: Public :: ChangeAlbum
+		public void ChangeAlbum (Item album)
+		{
+			albums_changed.Add (album);
+		}
+
+		// Methods :: Public :: RemoveAlbum
+		public void RemoveAlbum (Item album)
+		{
+			albums_removed.Add (album);
+		}
+
+		// Methods :: Public :: Deregister
+		/// <summary>
+		///	Deregister <paramref name="item" /> when the batch
+		///	ends, after the events.
+		/// </summary>
+		public void Deregister (Item item)
+		{
+			dead.Add (item);
+		}
+
+		// Methods :: Public :: Finish
+		/// <summary>
+		///	Emit the events with <paramref name="emit" />, in the
+		///	order of <see cref="Signal" />, skipping empty ones,
+		///	then deregister the removed items.
+		/// </summary>
+		public void Finish (EmitFunction emit)
+		{
+			Prune (songs_added, songs_changed, songs_removed);
+			Prune (albums_added, albums_changed, albums_removed);
+
+			try {
+				Emit (emit, Signal.SongsAdded,    songs_added,    song_type );
+				Emit (emit, Signal.AlbumsAdded,   albums_added,   album_type);
+				Emit (emit, Signal.SongsChanged,  songs_changed,  song_type );
+				Emit (emit, Signal.AlbumsChanged, albums_changed, album_type);
+				Emit (emit, Signal.SongsRemoved,  songs_removed,  song_type );
+				Emit (emit, Signal.AlbumsRemoved, albums_removed, album_type);
+
+			} finally {
+				foreach (Item item in dead)
+					item.Deregister ();
+			}
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: Prune
+		private static void Prune (ItemSet added, ItemSet changed, ItemSet removed)
+		{
+			foreach (Item item in removed.ToArray (typeof (Item))) {
+				changed.Remove (item);
+
+				if (!added.Contains (item))
+					continue;
+
+				added  .Remove (item);
+				removed.Remove (item);
+			}
+		}
+
+		// Methods :: Private :: Emit
+		private static void Emit (EmitFunction emit, Signal signal,
+					  ItemSet items, Type type)
+		{
+			if (items.Count == 0)
+				return;
+
+			emit (signal, items.ToArray (type));
+		}
+
+		// Internal Classes
+		// Internal Classes :: ItemSet
+		//	Items in the order they were first added, without
+		//	duplicates.
+		private class ItemSet
+		{
+			// Objects
+			private ArrayList items = new ArrayList ();
+			private Hashtable index = new Hashtable ();
+
+			// Properties
+			// Properties :: Count (get;)
+			public int Count {
+				get { return items.Count; }
+			}
+
+			// Methods
+			// Methods :: Public
+			// Methods :: Public :: Add
+			public void Add (object item)
+			{
+				if (index.ContainsKey (item))
+					return;
+
+				index [item] = true;
+				items.Add (item);
+			}
+
+			// Methods :: Public :: Contains
+			public bool Contains (object item)
+			{
+				return index.ContainsKey (item);
+			}
+
+			// Methods :: Public :: Remove
+			public void Remove (object item)
+			{
+				if (!index.ContainsKey (item))
+					return;
+
+				index.Remove (item);
+				items.Remove (item);
+			}
+
+			// Methods :: Public :: ToArray
+			public Array ToArray (Type type)
+			{
+				return items.ToArray (type);
+			}
+		}
+	}
+}
@@ -46,7 +46,6 @@ namespace Muine
 		}
 
 		// Objects
-		private Gdk.Pixbuf cover_image;
 		private ArrayList handles;
 
 		// Variables
@@ -187,14 +186,10 @@ namespace Muine
 			get { return duration; }
 		}
 
-		// Properties :: CoverImage (set; get;)
+		// Properties :: CoverImage (get;)
+		//	Decoded on demand by the cover database
 		public override Gdk.Pixbuf CoverImage {
-			set {
-				cover_image = value;
-				Global.DB.EmitSongChanged (this);
-			}
-		
-			get { return cover_image; }
+			get { return Global.CoverDB.GetCover (CoverKey); }
 		}
 
 		// Properties :: MTime (get;)
@@ -217,6 +212,12 @@ namespace Muine
 			get { return Global.DB.MakeAlbumKey (Folder, album); }
 		}
 
+		// Properties :: CoverKey (get;)
+		//	The album key, or the filename for single songs
+		private string CoverKey {
+			get { return HasAlbum ? AlbumKey : filename; }
+		}
+
 		// Properties :: Dead (get;)
 		public bool Dead {
 			get { return dead; }
@@ -234,10 +235,25 @@ namespace Muine
 
 		// Methods
 		// Methods :: Public
-		// Methods :: Public :: SetCoverImageQuiet
-		public void SetCoverImageQuiet (Pixbuf cover_image)
+		// Methods :: Public :: Move
+		//	Only for SongDatabase, which rekeys the song
+		public void Move (string new_filename)
+		{
+			filename = new_filename;
+		}
+
+		// Methods :: Public :: EmitCoverChanged
+		public override void EmitCoverChanged ()
+		{
+			Global.DB.EmitSongChanged (this);
+		}
+
+		// Methods :: Public :: Kill
+		//	Marks the song as removed, while its handles keep
+		//	working until Deregister.
+		public void Kill ()
 		{
-			this.cover_image = cover_image;
+			dead = true;
 		}
 
 		// Methods :: Public :: Deregister
@@ -258,14 +274,22 @@ namespace Muine
 		// 	Support for having multiple handles to the same song,
 		// 	used for, for example, having the same song in the 
 		//	playlist more than once.
+		//
+		//	Songs are created from several import threads at
+		//	once, so the counter needs a lock.
 		public IntPtr RegisterHandle ()
 		{
-			cur_ptr = new IntPtr (((int) cur_ptr) + 1);
-			pointers [cur_ptr] = this;
+			IntPtr ptr;
+
+			lock (pointers.SyncRoot) {
+				cur_ptr = new IntPtr (((int) cur_ptr) + 1);
+				ptr = cur_ptr;
+				pointers [ptr] = this;
+			}
 
-			handles.Add (cur_ptr);
+			handles.Add (ptr);
 
-			return cur_ptr;
+			return ptr;
 		}
 	
 		// Methods :: Public :: RegisterExtraHandle
@@ -332,34 +356,22 @@ namespace Muine
 			//
 			// Also, this is safe here as Sync () is only called for new or 
 			// actually changed songs. Never from db.Load.
-			if (!had_album && HasAlbum && cover_image != null) {
+			if (!had_album && HasAlbum) {
 
-				// This used to be a single song, but not anymore, and it does
-				// have a cover - migrate the cover to the album, if there is
-				// none there yet
-				Global.CoverDB.RemoveCover (filename);
-
-				string akey = AlbumKey;
-				if (Global.CoverDB.Covers [akey] == null)
-					Global.CoverDB.SetCover (akey, cover_image);
-
-			// See if there is a cover for this single song
-			} else if (!HasAlbum) { 
-				cover_image = (Pixbuf) Global.CoverDB.Covers [filename];
+				// This used to be a single song, but not anymore - 
+				// migrate its cover to the album, if there is none
+				// there yet
+				Global.CoverDB.MoveCover (filename, AlbumKey, false);
 			}
 			
-			if (cover_image == null && metadata.AlbumArt != null) {
+			string key = CoverKey;
+
+			if (metadata.AlbumArt != null && !Global.CoverDB.HasCover (key)) {
 				// Look for an ID3 embedded cover image, if it 
 				// is there, and no cover image is set yet, set
 				// it as cover image if it is a single song, or
 				// as album cover image if it belongs to an album 
-				string key = HasAlbum ? AlbumKey : filename;
-
-				if (Global.CoverDB.Covers [key] == null) {
-					cover_image =
-					  Global.CoverDB.Getter.GetEmbedded
-					    (key, metadata.AlbumArt);
-				}
+				Global.CoverDB.Getter.GetEmbedded (key, metadata.AlbumArt);
 
 				// Album itself will pick up change when this 
 				// song is added to it
@@ -393,15 +405,17 @@ namespace Muine
 		// 	Only call if it is a single song
 		public void SetCoverLocal (string file)
 		{
-			CoverImage = Global.CoverDB.Getter.GetLocal (filename, file);
+			Global.CoverDB.Getter.GetLocal (filename, file);
+			EmitCoverChanged ();
 		}
 
 		// Methods :: Public :: SetCoverWeb
 		// 	Only call if it is a single song
 		public void SetCoverWeb (string url)
 		{
-			CoverImage = Global.CoverDB.Getter.GetWeb (filename, url,
+			Global.CoverDB.Getter.GetWeb (filename, url,
 				new CoverGetter.GotCoverDelegate (OnGotCover));
+			EmitCoverChanged ();
 		}
 
 		// Methods :: Protected
@@ -433,7 +447,7 @@ namespace Muine
 		// Handlers :: OnGotCover
 		private void OnGotCover (Pixbuf pixbuf)
 		{
-			CoverImage = pixbuf;
+			EmitCoverChanged ();
 		}
 	}
 }
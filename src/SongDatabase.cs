@@ -35,6 +35,15 @@ namespace Muine
 		private const string GConfKeyOnlyCompleteAlbums = "/apps/muine/only_complete_albums";
 		private const bool GConfDefaultOnlyCompleteAlbums = true;
 
+		// Constants
+		// Constants :: WalkBatchSize
+		//	Number of files fetched from the directory walker at once
+		private const int WalkBatchSize = 256;
+
+		// Constants :: IoBatchSize
+		//	Number of songs stat'ed at once when checking for changes
+		private const int IoBatchSize = 256;
+
 		// Events
 		// Events :: SongAdded
 		public delegate void SongAddedHandler (Song song);
@@ -60,19 +69,72 @@ namespace Muine
 		public delegate void AlbumRemovedHandler (Album album);
 		public event         AlbumRemovedHandler  AlbumRemoved;
 
+		// Events :: SongsAdded
+		//	The batched events below carry every item of a signal
+		//	batch at once, when the batch ends. Outside of batches
+		//	they carry a single item, right after the events above.
+		public delegate void SongsAddedHandler (Song [] songs);
+		public event         SongsAddedHandler  SongsAdded ;
+
+		// Events :: SongsChanged
+		public delegate void SongsChangedHandler (Song [] songs);
+		public event         SongsChangedHandler  SongsChanged;
+
+		// Events :: SongsRemoved
+		public delegate void SongsRemovedHandler (Song [] songs);
+		public event         SongsRemovedHandler  SongsRemoved;
+
+		// Events :: AlbumsAdded
+		public delegate void AlbumsAddedHandler (Album [] albums);
+		public event         AlbumsAddedHandler  AlbumsAdded  ;
+
+		// Events :: AlbumsChanged
+		public delegate void AlbumsChangedHandler (Album [] albums);
+		public event         AlbumsChangedHandler  AlbumsChanged;
+
+		// Events :: AlbumsRemoved
+		public delegate void AlbumsRemovedHandler (Album [] albums);
+		public event         AlbumsRemovedHandler  AlbumsRemoved;
+
 		// Events :: WatchedFoldersChanged
 		public delegate void WatchedFoldersChangedHandler ();
 		public event         WatchedFoldersChangedHandler  WatchedFoldersChanged;
 
+		// Events :: CheckingChangesChanged
+		public delegate void CheckingChangesChangedHandler ();
+		public event         CheckingChangesChangedHandler  CheckingChangesChanged;
+
 		// Objects
 		private Database db;
+		private DirectoryDatabase dir_db = null;
+		private RejectedFileDatabase reject_db = null;
+		private FileIdDatabase id_db = null;
+
+		//	Folders to import, and the thread importing them
+		private ImportQueue import_queue = new ImportQueue ();
+		private AddFoldersThread import_thread = null;
+
+		//	The check for changes, if one is running
+		private CheckChangesThread check_thread = null;
 
 		// Variables
 		private Hashtable songs;
 		private Hashtable albums;
+		private Hashtable basenames;
 		private string [] watched_folders;
 		private bool only_complete_albums;
 
+		//	Albums changed during a signal batch, in order, and
+		//	whether their songs changed too; null outside batches
+		private ArrayList batch_albums = null;
+		private Hashtable batch_album_songs_changed;
+		private Hashtable batch_removed_albums;
+
+		//	Items for the batched events, collected until the
+		//	outermost batch ends
+		private int batch_depth = 0;
+		private SignalBatch signal_batch = null;
+
 		// Properties
 		// 	When iterating Song or Albums of these don't forget to 
 		//	lock the DB, otherwise the hash might be changed by another 
@@ -101,8 +163,25 @@ namespace Muine
 		{
 			db = new Database (FileUtils.SongsDBFile, version);
 
-			songs  = new Hashtable ();
-			albums = new Hashtable ();
+			songs     = new Hashtable ();
+			albums    = new Hashtable ();
+			basenames = new Hashtable ();
+
+			// Only speed up rescans, so we can do without
+			try {
+				dir_db = new DirectoryDatabase (1);
+			} catch {
+			}
+
+			try {
+				reject_db = new RejectedFileDatabase (1);
+			} catch {
+			}
+
+			try {
+				id_db = new FileIdDatabase (1);
+			} catch {
+			}
 
 			watched_folders = (string []) Config.Get (GConfKeyWatchedFolders, 
 				GConfDefaultWatchedFolders);
@@ -171,6 +250,93 @@ namespace Muine
 			}
 		}
 
+		// Methods :: Public :: MoveSong
+		/// <summary>
+		///	Tell the database <paramref name="song" /> was moved to
+		///	<paramref name="filename" />.
+		/// </summary>
+		/// <remarks>
+		///	The song keeps its tags, cover and handles; only its
+		///	key changes. Album covers move to the new album key.
+		///
+		///	If <paramref name="filename" /> is a song already, it
+		///	was overwritten: <paramref name="song" /> is removed, and
+		///	the other song is read again.
+		/// </remarks>
+		public void MoveSong (Song song, string filename)
+		{
+			SignalRequest rq;
+			try {
+				rq = StartMoveSong (song, filename);
+				HandleSignalRequest (rq);
+				return;
+
+			} catch (InvalidOperationException) {
+			}
+
+			Song existing;
+			lock (this)
+				existing = (Song) Songs [filename];
+
+			// Or song is gone already
+			if (existing == null || existing == song)
+				return;
+
+			RemoveSong (song);
+
+			Metadata metadata;
+			try {
+				metadata = new Metadata (filename);
+
+			} catch {
+				RemoveSong (existing);
+				return;
+			}
+
+			try {
+				rq = StartSyncSong (existing, metadata);
+				HandleSignalRequest (rq);
+
+			} catch (InvalidOperationException) {
+			}
+		}
+
+		// Methods :: Public :: MoveFolder
+		/// <summary>
+		///	Tell the database <paramref name="old_folder" /> was
+		///	moved to <paramref name="new_folder" />.
+		/// </summary>
+		/// <remarks>
+		///	Songs moved over songs in <paramref name="new_folder" />
+		///	are handled as in <see cref="MoveSong" />.
+		/// </remarks>
+		public void MoveFolder (string old_folder, string new_folder)
+		{
+			BeginSignalBatch ();
+
+			try {
+				string prefix = old_folder + "/";
+
+				// Moving may read tags and rekey covers, so only
+				// collect the songs with the lock held
+				ArrayList moved = new ArrayList ();
+				lock (this) {
+					foreach (string path in songs.Keys) {
+						if (path.StartsWith (prefix))
+							moved.Add (songs [path]);
+					}
+				}
+
+				foreach (Song song in moved) {
+					string rest = song.Filename.Substring (prefix.Length);
+					MoveSong (song, Path.Combine (new_folder, rest));
+				}
+
+			} finally {
+				EndSignalBatch ();
+			}
+		}
+
 		// Methods :: Public :: AddWatchedFolders
 		public void AddWatchedFolders (ArrayList folders)
 		{
@@ -179,15 +345,17 @@ namespace Muine
 
 			Config.Set (GConfKeyWatchedFolders, watched_folders);
 
-			new AddFoldersThread (folders);
+			QueueFolders (folders, ImportQueue.Priority.User);
 		}
 
 		// Methods :: Public :: AddFolder
+		//	Used for folders which showed up by themselves, so
+		//	what the user asked for goes first.
 		public void AddFolder (string folder)
 		{
 			ArrayList list = new ArrayList ();
 			list.Add (new DirectoryInfo (folder));
-			new AddFoldersThread (list);
+			QueueFolders (list, ImportQueue.Priority.Background);
 		}
 
 		// Methods :: Public :: RemoveFolder
@@ -206,10 +374,43 @@ namespace Muine
 			}
 		}
 
+		// Properties :: CheckingChanges (get;)
+		/// <summary>
+		///	Whether a check for changes is running. Only one runs
+		///	at a time.
+		/// </summary>
+		public bool CheckingChanges {
+			get { return (check_thread != null); }
+		}
+
 		// Methods :: Public :: CheckChanges
 		public void CheckChanges ()
 		{
-			new CheckChangesThread ();
+			CheckChanges (false);
+		}
+
+		/// <summary>
+		///	Look for new, changed and removed songs.
+		/// </summary>
+		/// <param name="full">
+		///	If false, directories whose mtime didn't move since
+		///	they were last read are skipped, along with the songs
+		///	in them. If true, every directory is read and every
+		///	song is checked.
+		/// </param>
+		/// <remarks>
+		///	Does nothing if a check is running already, as two
+		///	checks would update the same songs at once.
+		/// </remarks>
+		public void CheckChanges (bool full)
+		{
+			if (check_thread != null)
+				return;
+
+			check_thread = new CheckChangesThread (dir_db, full);
+
+			if (CheckingChangesChanged != null)
+				CheckingChangesChanged ();
 		}
 
 		// Methods :: Public :: MakeAlbumKey
@@ -247,6 +448,49 @@ namespace Muine
 			return (Song) Songs [filename];
 		}
 
+		// Methods :: Public :: Getters :: GetSongByBasename
+		/// <summary>
+		///	Find a song living at another location than <paramref
+		///	name="filename" />, but with the same file name.
+		/// </summary>
+		/// <remarks>
+		///	Used to resolve playlists written on another machine.
+		///	When several songs share the file name, the one whose
+		///	path has the longest common trailing part with
+		///	<paramref name="filename" /> wins.
+		/// </remarks>
+		public Song GetSongByBasename (string filename)
+		{
+			string basename;
+			try {
+				basename = Path.GetFileName (filename);
+			} catch {
+				return null;
+			}
+
+			lock (this) {
+				ArrayList keys = (ArrayList) basenames [basename];
+				if (keys == null)
+					return null;
+
+				string best = (string) keys [0];
+				int best_len = -1;
+
+				if (keys.Count > 1) {
+					foreach (string key in keys) {
+						int len = CommonSuffixLength (key, filename);
+						if (len <= best_len)
+							continue;
+
+						best = key;
+						best_len = len;
+					}
+				}
+
+				return (Song) songs [best];
+			}
+		}
+
 		// Methods :: Public :: Getters :: GetAlbum
 		public Album GetAlbum (Song song)
 		{
@@ -258,12 +502,77 @@ namespace Muine
 			return (Album) Albums [key];
 		}
 							
+		// Methods :: Public :: BeginSignalBatch
+		/// <summary>
+		///	Start collecting signals for the batched events.
+		/// </summary>
+		/// <remarks>
+		///	Until the matching <see cref="EndSignalBatch" />, every
+		///	changed album is signalled only once, however many
+		///	changes touch it, and the batched events are held back.
+		///	Batches can be nested; only the outermost one counts.
+		///	Call this from the main loop.
+		/// </remarks>
+		public void BeginSignalBatch ()
+		{
+			lock (this) {
+				if (batch_depth++ > 0)
+					return;
+
+				batch_albums              = new ArrayList ();
+				batch_album_songs_changed = new Hashtable ();
+				batch_removed_albums      = new Hashtable ();
+
+				signal_batch = new SignalBatch (typeof (Song), typeof (Album));
+			}
+		}
+
+		// Methods :: Public :: EndSignalBatch
+		/// <summary>
+		///	Emit the batched events for everything that happened
+		///	since <see cref="BeginSignalBatch" />.
+		/// </summary>
+		/// <remarks>
+		///	Songs and albums removed during the batch are
+		///	deregistered after the events, see
+		///	<see cref="SignalBatch" />.
+		/// </remarks>
+		public void EndSignalBatch ()
+		{
+			lock (this) {
+				if (batch_depth == 0 || --batch_depth > 0)
+					return;
+
+				// Album changes were held back, and may change songs
+				ArrayList albums = batch_albums;
+				batch_albums = null;
+
+				foreach (Album album in albums) {
+					if (batch_removed_albums.ContainsKey (album))
+						continue;
+
+					EmitAlbumChangedInternal (album,
+						(bool) batch_album_songs_changed [album]);
+				}
+
+				batch_album_songs_changed = null;
+				batch_removed_albums      = null;
+
+				SignalBatch finished = signal_batch;
+				signal_batch = null;
+
+				finished.Finish (new SignalBatch.EmitFunction (EmitBatched));
+			}
+		}
+
 		// Methods :: Private
 		// Methods :: Private :: StartAddSong
 		private SignalRequest StartAddSong (Song song)
 		{
+			SignalRequest rq;
+
 			lock (this) {
-				SignalRequest rq = new SignalRequest (song);
+				rq = new SignalRequest (song);
 			
 				try {
 					Songs.Add (song.Filename, song);
@@ -272,6 +581,8 @@ namespace Muine
 					throw new InvalidOperationException ();
 				}
 
+				AddToBasenameIndex (song.Filename);
+
 				StartAddToAlbum (rq);
 
 				// Store after the album cover has been stored,
@@ -279,19 +590,23 @@ namespace Muine
 				SaveSongInternal (song, false);
 
 				rq.SongAdded = true;
-
-				return rq;
 			}
+
+			RememberFileId (song.Filename);
+
+			return rq;
 		}
 
 		// Methods :: Private :: StartSyncSong
 		private SignalRequest StartSyncSong (Song song, Metadata metadata)
 		{
+			SignalRequest rq;
+
 			lock (this) {
 				if (song.Dead)
 					throw new InvalidOperationException ();
 
-				SignalRequest rq = new SignalRequest (song);
+				rq = new SignalRequest (song);
 			
 				StartRemoveFromAlbum (rq);
 				song.Sync (metadata);
@@ -300,9 +615,11 @@ namespace Muine
 				SaveSongInternal (song, true);
 
 				rq.SongChanged = true;
-				
-				return rq;
 			}
+
+			RememberFileId (song.Filename);
+
+			return rq;
 		}
 
 		// Methods :: Private :: SaveSongInternal
@@ -324,13 +641,114 @@ namespace Muine
 
 				db.Delete (song.Filename);
 				Songs.Remove (rq.Song.Filename);
+				RemoveFromBasenameIndex (rq.Song.Filename);
 				StartRemoveFromAlbum (rq);
 				rq.SongRemoved = true;
 
+				if (id_db != null)
+					id_db.Remove (song.Filename);
+
 				return rq;
 			}
 		}
 
+		// Methods :: Private :: StartMoveSong
+		//	Covers are keyed by album key, or by filename for songs
+		//	without an album. They are copied to the new key before
+		//	the new album looks for one, and dropped from the old key
+		//	once nothing uses it, both without the lock held.
+		private SignalRequest StartMoveSong (Song song, string filename)
+		{
+			string old_cover_key, new_cover_key;
+			lock (this) {
+				if (song.Dead || Songs.ContainsKey (filename))
+					throw new InvalidOperationException ();
+
+				if (song.HasAlbum) {
+					old_cover_key = song.AlbumKey;
+					new_cover_key = MakeAlbumKey
+					  (Path.GetDirectoryName (filename), song.Album);
+
+				} else {
+					old_cover_key = song.Filename;
+					new_cover_key = filename;
+				}
+			}
+
+			bool rekey = (old_cover_key != new_cover_key);
+
+			bool copied = (rekey &&
+			               Global.CoverDB.HasCover (old_cover_key) &&
+			               !Global.CoverDB.HasCover (new_cover_key));
+
+			if (copied)
+				Global.CoverDB.MoveCover (old_cover_key, new_cover_key, true);
+
+			SignalRequest rq;
+			try {
+				rq = StartMoveSongInternal (song, filename);
+
+			} catch (InvalidOperationException) {
+				if (copied)
+					Global.CoverDB.RemoveCover (new_cover_key);
+
+				throw;
+			}
+
+			if (rekey && (!song.HasAlbum || rq.RemovedAlbum != null))
+				Global.CoverDB.RemoveCover (old_cover_key);
+
+			return rq;
+		}
+
+		// Methods :: Private :: StartMoveSongInternal
+		private SignalRequest StartMoveSongInternal (Song song, string filename)
+		{
+			lock (this) {
+				if (song.Dead || Songs.ContainsKey (filename))
+					throw new InvalidOperationException ();
+
+				SignalRequest rq = new SignalRequest (song);
+
+				string old_filename = song.Filename;
+
+				db.Delete (old_filename);
+				Songs.Remove (old_filename);
+				RemoveFromBasenameIndex (old_filename);
+				StartRemoveFromAlbum (rq);
+
+				song.Move (filename);
+
+				Songs.Add (filename, song);
+				AddToBasenameIndex (filename);
+				StartAddToAlbum (rq);
+
+				SaveSongInternal (song, true);
+
+				if (id_db != null)
+					id_db.Move (old_filename, filename);
+
+				rq.SongChanged = true;
+
+				return rq;
+			}
+		}
+
+		// Methods :: Private :: RememberFileId
+		//	Stats and stores, so call without the lock held.
+		private void RememberFileId (string filename)
+		{
+			if (id_db == null)
+				return;
+
+			Mono.Unix.Native.Stat buf;
+			if (Mono.Unix.Native.Syscall.stat (filename, out buf) != 0)
+				return;
+
+			id_db.Store (filename, new FileIdDatabase.FileId
+			  (buf.st_dev, buf.st_ino, buf.st_size, (int) buf.st_mtime));
+		}
+
 		// Methods :: Private :: StartAddToAlbum
 		private void StartAddToAlbum (SignalRequest rq)
 		{
@@ -408,6 +826,51 @@ namespace Muine
 			rq.RemoveChangedAlbum = album;
 		}
 
+		// Methods :: Private :: AddToBasenameIndex
+		private void AddToBasenameIndex (string filename)
+		{
+			string basename = Path.GetFileName (filename);
+
+			ArrayList keys = (ArrayList) basenames [basename];
+			if (keys == null) {
+				keys = new ArrayList (1);
+				basenames.Add (basename, keys);
+			}
+
+			keys.Add (filename);
+		}
+
+		// Methods :: Private :: RemoveFromBasenameIndex
+		private void RemoveFromBasenameIndex (string filename)
+		{
+			string basename = Path.GetFileName (filename);
+
+			ArrayList keys = (ArrayList) basenames [basename];
+			if (keys == null)
+				return;
+
+			keys.Remove (filename);
+
+			if (keys.Count == 0)
+				basenames.Remove (basename);
+		}
+
+		// Methods :: Private :: CommonSuffixLength
+		private static int CommonSuffixLength (string a, string b)
+		{
+			int i = a.Length - 1;
+			int j = b.Length - 1;
+			int len = 0;
+
+			while (i >= 0 && j >= 0 && a [i] == b [j]) {
+				i --;
+				j --;
+				len ++;
+			}
+
+			return len;
+		}
+
 		// Methods :: Private :: AddToWatchedFolders
 		private void AddToWatchedFolders (string folder)
 		{
@@ -435,64 +898,73 @@ namespace Muine
 			watched_folders = (string []) new_folders.ToArray (string_type);
 		}
 
+		// Methods :: Private :: QueueFolders
+		//	Queues folders for the import thread, and starts it if
+		//	it isn't running.
+		private void QueueFolders (ArrayList folders, ImportQueue.Priority priority)
+		{
+			lock (import_queue) {
+				bool added = false;
+
+				foreach (DirectoryInfo dinfo in folders) {
+					if (import_queue.Add (dinfo.FullName, priority))
+						added = true;
+				}
+
+				if (added && import_thread == null)
+					import_thread = new AddFoldersThread ();
+			}
+		}
+
 		// Methods :: Private :: HandleDirectory
 		// <summary>Directory walking</summary>
+		//	Music files we don't know yet are handed to the
+		//	pipeline, which reads their tags and commits them.
+		//	Files in submitted are in the pipeline already.
 		private bool HandleDirectory
-		  (DirectoryInfo info, Queue queue, BooleanBox canceled_box)
+		  (string folder, ImportPipeline pipeline, BooleanBox canceled_box,
+		   Hashtable submitted)
 		{
-			// Files
-			FileInfo [] finfos;		
+			DirectoryWalker walker = new DirectoryWalker (folder);
+
 			try {
-				finfos = info.GetFiles ();
-			} catch {
-				return true;
-			}
+				string [] batch;
+				while ((batch = walker.NextBatch (WalkBatchSize)) != null) {
+					ArrayList new_files = new ArrayList (batch.Length);
 
-			// Find Songs
-			foreach (FileInfo finfo in finfos) {
-				// If cancelled, get out of this mess...
-				if (canceled_box.Value)
-					return false;
+					foreach (string file in batch) {
+						// If we already have the song, don't add it again
+						if (this.Songs.ContainsKey (file))
+							continue;
 
-				// If we already have the song, don't add it again
-				if (this.Songs.ContainsKey (finfo.FullName))
-					continue;
+						if (submitted.ContainsKey (file))
+							continue;
 
-				// Get Song
-				Song song;
-				try {
-					song = new Song (finfo.FullName);
-				} catch {
-					continue;
-				}
-	
-				// Add Song
-				SignalRequest rq;				
-				try {
-					rq = StartAddSong (song);
-				} catch (InvalidOperationException) {
-					continue;
-				}
+						submitted [file] = true;
+						new_files.Add (file);
+					}
 
-				// Queue Song
-				queue.Enqueue (rq);
-			}
+					Type string_type = typeof (string);
+					string [] files = (string []) new_files.ToArray (string_type);
 
-			// Directories
-			DirectoryInfo [] dinfos;
-			
-			try {
-				dinfos = info.GetDirectories ();
-			} catch {
-				return true;
-			}
+					// Pull the tags into the page cache, while the
+					// pipeline is still busy with the previous batch
+					ImportScheduler.WaitTurn ();
+					IoBatch.Prefetch (files);
 
-			// Recurse Directories
-			foreach (DirectoryInfo dinfo in dinfos) {
-				if (HandleDirectory (dinfo, queue, canceled_box))
-					continue;
-				
-				return false;
+					foreach (string file in files) {
+						// If cancelled, get out of this mess...
+						if (canceled_box.Value)
+							return false;
+
+						// Queue Song
+						if (!pipeline.Submit (file))
+							return false;
+					}
+				}
+
+			} finally {
+				walker.Close ();
 			}
 
 			return true;
@@ -514,7 +986,7 @@ namespace Muine
 
 				} else if (rq.SongRemoved) {
 					EmitSongRemoved (rq.Song);
-					rq.Song.Deregister ();
+					DeregisterItem (rq.Song);
 				}
 				
 				// Albums
@@ -524,77 +996,193 @@ namespace Muine
 				
 				if (rq.RemovedAlbum != null) {
 					EmitAlbumRemoved (rq.RemovedAlbum);
-					rq.RemovedAlbum.Deregister ();
+					DeregisterItem (rq.RemovedAlbum);
+
+					if (batch_albums != null)
+						batch_removed_albums [rq.RemovedAlbum] = true;
 				}
 
-				if (rq.AddChangedAlbum != null) {
-					EmitAlbumChanged (rq.AddChangedAlbum);
+				if (rq.AddChangedAlbum != null)
+					AlbumChangedInternal (rq.AddChangedAlbum, rq.AlbumSongsChanged);
 
-					if (rq.AlbumSongsChanged)
-						foreach (Song s in rq.AddChangedAlbum.Songs)
-							EmitSongChanged (s);
+				if (rq.RemoveChangedAlbum != null)
+					AlbumChangedInternal (rq.RemoveChangedAlbum, false);
+			}
+		}
 
-				}
+		// Methods :: Private :: DeregisterItem
+		//	Handlers of the batched events may still look up the
+		//	item by its handles, so wait for the batch to end.
+		private void DeregisterItem (Item item)
+		{
+			if (signal_batch == null) {
+				item.Deregister ();
+				return;
+			}
 
-				if (rq.RemoveChangedAlbum != null) {
-					EmitAlbumChanged (rq.RemoveChangedAlbum);
-				}
+			Song song = item as Song;
+			if (song != null)
+				song.Kill ();
+
+			signal_batch.Deregister (item);
+		}
+
+		// Methods :: Private :: AlbumChangedInternal
+		private void AlbumChangedInternal (Album album, bool songs_changed)
+		{
+			if (batch_albums == null) {
+				EmitAlbumChangedInternal (album, songs_changed);
+				return;
+			}
+
+			if (batch_album_songs_changed.ContainsKey (album)) {
+				if (songs_changed)
+					batch_album_songs_changed [album] = true;
+
+				return;
 			}
+
+			batch_albums.Add (album);
+			batch_album_songs_changed [album] = songs_changed;
+		}
+
+		// Methods :: Private :: EmitAlbumChangedInternal
+		private void EmitAlbumChangedInternal (Album album, bool songs_changed)
+		{
+			EmitAlbumChanged (album);
+
+			if (!songs_changed)
+				return;
+
+			foreach (Song s in album.Songs)
+				EmitSongChanged (s);
 		}
 
 		// Methods :: Private :: Signal Emitters
 		// Methods :: Private :: Signal Emitters :: EmitSongAdded
 		private void EmitSongAdded (Song song)
 		{
-			if (SongAdded == null)
+			if (SongAdded != null)
+				SongAdded (song);
+
+			if (signal_batch != null) {
+				signal_batch.AddSong (song);
 				return;
+			}
 
-			SongAdded (song);
+			if (SongsAdded != null)
+				SongsAdded (new Song [] { song });
 		}
 
 		// Methods :: Private :: Signal Emitters :: EmitSongChanged
 		public void EmitSongChanged (Song song)
 		{
-			if (SongChanged == null)
+			if (SongChanged != null)
+				SongChanged (song);
+
+			if (signal_batch != null) {
+				signal_batch.ChangeSong (song);
 				return;
+			}
 
-			SongChanged (song);
+			if (SongsChanged != null)
+				SongsChanged (new Song [] { song });
 		}
 
 		// Methods :: Private :: Signal Emitters :: EmitSongRemoved
 		private void EmitSongRemoved (Song song)
 		{
-			if (SongRemoved == null)
+			if (SongRemoved != null)
+				SongRemoved (song);
+
+			if (signal_batch != null) {
+				signal_batch.RemoveSong (song);
 				return;
+			}
 
-			SongRemoved (song);
+			if (SongsRemoved != null)
+				SongsRemoved (new Song [] { song });
 		}
 
 		// Methods :: Private :: Signal Emitters :: EmitAlbumAdded
 		private void EmitAlbumAdded (Album album)
 		{
-			if (AlbumAdded == null)
+			if (AlbumAdded != null)
+				AlbumAdded (album);
+
+			if (signal_batch != null) {
+				signal_batch.AddAlbum (album);
 				return;
+			}
 
-			AlbumAdded (album);
+			if (AlbumsAdded != null)
+				AlbumsAdded (new Album [] { album });
 		}
 
 		// Methods :: Private :: Signal Emitters :: EmitAlbumChanged
 		public void EmitAlbumChanged (Album album)
 		{
-			if (AlbumChanged == null)
+			if (AlbumChanged != null)
+				AlbumChanged (album);
+
+			if (signal_batch != null) {
+				signal_batch.ChangeAlbum (album);
 				return;
+			}
 
-			AlbumChanged (album);
+			if (AlbumsChanged != null)
+				AlbumsChanged (new Album [] { album });
 		}
 
 		// Methods :: Private :: Signal Emitters :: EmitAlbumRemoved
 		private void EmitAlbumRemoved (Album album)
 		{
-			if (AlbumRemoved == null)
+			if (AlbumRemoved != null)
+				AlbumRemoved (album);
+
+			if (signal_batch != null) {
+				signal_batch.RemoveAlbum (album);
 				return;
+			}
 
-			AlbumRemoved (album);
+			if (AlbumsRemoved != null)
+				AlbumsRemoved (new Album [] { album });
+		}
+
+		// Methods :: Private :: Signal Emitters :: EmitBatched
+		private void EmitBatched (SignalBatch.Signal signal, Array items)
+		{
+			switch (signal) {
+			case SignalBatch.Signal.SongsAdded:
+				if (SongsAdded != null)
+					SongsAdded ((Song []) items);
+				break;
+
+			case SignalBatch.Signal.AlbumsAdded:
+				if (AlbumsAdded != null)
+					AlbumsAdded ((Album []) items);
+				break;
+
+			case SignalBatch.Signal.SongsChanged:
+				if (SongsChanged != null)
+					SongsChanged ((Song []) items);
+				break;
+
+			case SignalBatch.Signal.AlbumsChanged:
+				if (AlbumsChanged != null)
+					AlbumsChanged ((Album []) items);
+				break;
+
+			case SignalBatch.Signal.SongsRemoved:
+				if (SongsRemoved != null)
+					SongsRemoved ((Song []) items);
+				break;
+
+			case SignalBatch.Signal.AlbumsRemoved:
+				if (AlbumsRemoved != null)
+					AlbumsRemoved ((Album []) items);
+				break;
+			}
 		}
 
 		// Handlers
@@ -630,7 +1218,7 @@ namespace Muine
 			if (new_dinfos.Count <= 0)
 				return;
 
-			new AddFoldersThread (new_dinfos);
+			QueueFolders (new_dinfos, ImportQueue.Priority.Background);
 		}
 		// Handlers :: OnOnlyCompleteAlbumsChanged
 		private void OnOnlyCompleteAlbumsChanged (object o, GConf.NotifyEventArgs args)
@@ -645,6 +1233,7 @@ namespace Muine
 			Song song = new Song (key, data);
 
 			Songs.Add (key, song);
+			AddToBasenameIndex (key);
 			
 			// We don't "Finish", as we do this before the UI is there,
 			// we don't need to emit signals
@@ -690,28 +1279,61 @@ namespace Muine
 			}
 		}
 
+		// Internal Classes :: SignalThread
+		//	A thread handing SignalRequests to the main loop, which
+		//	signals the album changes of every batch only once.
+		private abstract class SignalThread : ThreadBase
+		{
+			// Methods
+			// Methods :: Protected
+			// Methods :: Protected :: HandleItem (ThreadBase)
+			protected override void HandleItem (object item)
+			{
+				Global.DB.HandleSignalRequest ((SignalRequest) item);
+			}
+
+			// Methods :: Protected :: BatchStarted (ThreadBase)
+			protected override void BatchStarted ()
+			{
+				Global.DB.BeginSignalBatch ();
+			}
+
+			// Methods :: Protected :: BatchFinished (ThreadBase)
+			protected override void BatchFinished ()
+			{
+				Global.DB.EndSignalBatch ();
+			}
+		}
+
 		// Internal Classes :: AddFoldersThread
+		//	Imports the folders in the import queue, until it's
+		//	empty. There's only one at a time, so imports share a
+		//	pipeline and a progress window.
 		//	TODO: Split off?
-		private class AddFoldersThread : ThreadBase
+		private class AddFoldersThread : SignalThread
 		{
 			// Objects
 			private ProgressWindow pw;
+			private ImportPipeline pipeline;
 			private BooleanBox canceled_box = new BooleanBox (false);
+
+			//	Files handed to the pipeline, which may not be
+			//	in the database yet
+			private Hashtable submitted = new Hashtable ();
 			
 			// Variables
-			private ArrayList folders;
-			private DirectoryInfo current_folder;
+			private string current_folder = null;
+			private string last_file = null;
 			
 			// Constructor
-			public AddFoldersThread (ArrayList folders)
+			public AddFoldersThread ()
 			{
-				this.folders = folders;
+				pipeline = new ImportPipeline
+				  (new ImportPipeline.CommitFunc (CommitFunc),
+				   Global.DB.reject_db);
 
 				pw = new ProgressWindow (Global.Playlist);
 
-				current_folder = (DirectoryInfo) folders [0];
-				pw.Report (current_folder.Name, current_folder.Name);
-
 				thread.Start ();
 			}
 
@@ -719,113 +1341,522 @@ namespace Muine
 			// Delegate Functions :: ThreadFunc
 			protected override void ThreadFunc ()
 			{
-				foreach (DirectoryInfo dinfo in folders) {
-					current_folder = dinfo;
-					Global.DB.HandleDirectory (dinfo, queue, canceled_box);
+				ImportScheduler.EnterImportThread ();
+
+				pipeline.Start ();
+
+				ImportQueue import_queue = Global.DB.import_queue;
+
+				while (true) {
+					string folder;
+
+					lock (import_queue) {
+						if (canceled_box.Value)
+							import_queue.Clear ();
+
+						folder = import_queue.Next ();
+
+						// Whatever is queued from now on needs
+						// a new thread
+						if (folder == null) {
+							Global.DB.import_thread = null;
+							break;
+						}
+					}
+
+					current_folder = folder;
+
+					Global.DB.HandleDirectory (folder, pipeline,
+						canceled_box, submitted);
+
+					import_queue.Done (folder);
 				}
 
-				thread_done = true;
+				pipeline.Finish ();
 			}
-			
-			// Delegate Functions :: MainLoopIdle
-			protected override bool MainLoopIdle ()
+
+			// Delegate Functions :: CommitFunc (ImportPipeline)
+			private void CommitFunc (string filename, Song song)
 			{
-				if (queue.Count == 0) {
-					if (thread_done) {
-						pw.Done ();
-						return false;
-					}
-					
-					return true;
+				try {
+					Enqueue (Global.DB.StartAddSong (song));
+				} catch (InvalidOperationException) {
 				}
+			}
+
+			// Methods
+			// Methods :: Protected
+			// Methods :: Protected :: HandleItem (ThreadBase)
+			protected override void HandleItem (object item)
+			{
+				last_file = ((SignalRequest) item).Song.Filename;
 
-				SignalRequest rq = (SignalRequest) queue.Dequeue ();
+				base.HandleItem (item);
+			}
+
+			// Methods :: Protected :: BatchFinished (ThreadBase)
+			protected override void BatchFinished ()
+			{
+				base.BatchFinished ();
 
-				canceled_box.Value = pw.Report (current_folder.Name,
-					Path.GetFileName (rq.Song.Filename));
+				string folder = current_folder;
+				if (folder == null)
+					return;
 
-				Global.DB.HandleSignalRequest (rq);
-	
-				return true;
+				canceled_box.Value = pw.Report (Path.GetFileName (folder),
+					Path.GetFileName (last_file));
+
+				if (canceled_box.Value)
+					pipeline.Cancel ();
+
+				pw.ReportRate (pipeline.FilesPerSecond,
+					pipeline.NWaitingToRead,
+					pipeline.NWaitingToCommit + queue.Count,
+					Global.DB.import_queue.Count);
+			}
+
+			// Methods :: Protected :: Finished (ThreadBase)
+			protected override void Finished ()
+			{
+				pw.Done ();
+
+				DebugLog.Write ("import: {0} reads held back for playback",
+					ImportScheduler.NStalls);
+
+				Global.CoverDB.Getter.WriteDebugLog ();
 			}
 		}
 
 		// Internal Classes :: CheckChangesThread
 		//	TODO: Split off?
-		private class CheckChangesThread : ThreadBase
+		private class CheckChangesThread : SignalThread
 		{
+			// Objects
+			private DirectoryDatabase dir_db;
+			private ImportPipeline pipeline;
+
+			// Variables
+			private bool full;
+
+			//	Songs not checked yet, by directory
+			private Hashtable songs_by_dir = new Hashtable ();
+
+			//	Directories read or skipped, by "dev:ino"
+			private Hashtable visited = new Hashtable ();
+
+			//	States to store once all new songs are committed
+			private Hashtable new_states = new Hashtable ();
+
+			//	Songs to stat
+			private ArrayList to_check = new ArrayList ();
+
+			//	Music files we don't have yet, and songs whose
+			//	file is gone; some of them may be the same file
+			private ArrayList new_files = new ArrayList ();
+			private ArrayList missing   = new ArrayList ();
+
 			// Constructor
-			public CheckChangesThread ()
+			public CheckChangesThread (DirectoryDatabase dir_db, bool full)
 			{
+				this.dir_db = dir_db;
+				this.full   = (full || dir_db == null);
+
 				thread.Start ();
 			}
 
 			// Delegate Functions
-			// Delegate Functions :: MainLoopIdle (ThreadBase)
-			protected override bool MainLoopIdle ()
+			// Delegate Functions :: ThreadFunc (ThreadBase)
+			protected override void ThreadFunc ()
 			{
-				if (queue.Count == 0)
-					return !thread_done;
-
-				SignalRequest rq = (SignalRequest) queue.Dequeue ();
+				ImportScheduler.EnterImportThread ();
 
-				Global.DB.HandleSignalRequest (rq);
+				if (dir_db != null)
+					dir_db.Load ();
 
-				return true;
-			}
+				if (Global.DB.id_db != null)
+					Global.DB.id_db.Load ();
 
-			// Delegate Functions :: ThreadFunc (ThreadBase)
-			protected override void ThreadFunc ()
-			{
 				Hashtable snapshot;
 				lock (Global.DB)
 					snapshot = (Hashtable) Global.DB.Songs.Clone ();
 
-				// Check for removed songs and changes
-				foreach (string file in snapshot.Keys) {
-					FileInfo finfo = new FileInfo (file);
-					Song song = (Song) snapshot [file];
+				foreach (Song song in snapshot.Values) {
+					string dir = Path.GetDirectoryName (song.Filename);
 
-					SignalRequest rq = null;
+					ArrayList list = (ArrayList) songs_by_dir [dir];
+					if (list == null) {
+						list = new ArrayList ();
+						songs_by_dir [dir] = list;
+					}
+
+					list.Add (song);
+				}
 
-					if (!finfo.Exists) {
-						rq = Global.DB.StartRemoveSong (song);
+				pipeline = new ImportPipeline
+				  (new ImportPipeline.CommitFunc (CommitFunc),
+				   Global.DB.reject_db);
 
-					} else {
-						long ticks = FileUtils.MTimeToTicks (song.MTime);
-						if (ticks < finfo.LastWriteTimeUtc.Ticks) {
-							try {
-								Metadata metadata =
-								  new Metadata (song.Filename);
-
-								rq = Global.DB.StartSyncSong (song, metadata);
-
-							} catch {
-								try {
-									rq = Global.DB.StartRemoveSong (song);
-								} catch (InvalidOperationException) {
-								}
+				pipeline.Start ();
+
+				// Walk the watched folders, checking the songs in
+				// directories that changed and looking for new ones
+				foreach (string folder in Global.DB.WatchedFolders)
+					CheckFolder (folder);
+
+				// Songs outside the watched folders, or in
+				// directories we couldn't read
+				foreach (ArrayList list in songs_by_dir.Values)
+					to_check.AddRange (list);
+
+				CheckSongs ();
+
+				// Files that were moved are rekeyed, the rest is
+				// read, or removed
+				FindMoves ();
+
+				foreach (string file in new_files)
+					pipeline.Submit (file);
+
+				foreach (Song song in missing)
+					RemoveSong (song);
+
+				pipeline.Finish ();
+
+				// Only now, so new songs that didn't make it into
+				// the database are found again next time
+				if (dir_db != null)
+					StoreStates ();
+
+				if (Global.DB.reject_db != null)
+					PruneRejects (Global.DB.reject_db);
+			}
+
+			// Methods
+			// Methods :: Protected
+			// Methods :: Protected :: Finished (ThreadBase)
+			protected override void Finished ()
+			{
+				SongDatabase db = Global.DB;
+
+				db.check_thread = null;
+
+				DebugLog.Write ("import: {0} reads held back for playback",
+					ImportScheduler.NStalls);
+
+				if (db.CheckingChangesChanged != null)
+					db.CheckingChangesChanged ();
+			}
+
+			// Methods :: Private
+			// Methods :: Private :: CheckFolder
+			private void CheckFolder (string folder)
+			{
+				Stack pending = new Stack ();
+				pending.Push (folder);
+
+				while (pending.Count > 0) {
+					string dir = (string) pending.Pop ();
+
+					Mono.Unix.Native.Stat buf;
+					if (Mono.Unix.Native.Syscall.stat (dir, out buf) != 0)
+						continue;
+
+					Mono.Unix.Native.FilePermissions type =
+					  buf.st_mode & Mono.Unix.Native.FilePermissions.S_IFMT;
+					if (type != Mono.Unix.Native.FilePermissions.S_IFDIR)
+						continue;
+
+					// Don't follow symlink loops
+					string id = String.Format ("{0}:{1}", buf.st_dev, buf.st_ino);
+					if (visited.ContainsKey (id))
+						continue;
+
+					visited [id] = true;
+
+					int mtime = (int) buf.st_mtime;
+
+					DirectoryDatabase.DirectoryState state = null;
+					if (!full)
+						state = dir_db [dir];
+
+					if (state != null && (state.MTime != mtime || state.Id != id))
+						state = null;
+
+					// Mtime didn't move, but it might have been
+					// modified right after we last read it
+					string [] entries = null;
+					if (state != null && state.IsRacy) {
+						entries = DirectoryWalker.List (dir);
+
+						if (entries == null || !state.Matches (entries))
+							state = null;
+						else
+							state = new DirectoryDatabase.DirectoryState
+							  (mtime, id, entries);
+					}
+
+					if (state != null) {
+						// Unchanged, so are the songs in it; but we
+						// may not know their files yet
+						ArrayList songs = (ArrayList) songs_by_dir [dir];
+						songs_by_dir.Remove (dir);
+
+						if (songs != null && Global.DB.id_db != null) {
+							foreach (Song song in songs) {
+								if (Global.DB.id_db [song.Filename] == null)
+									to_check.Add (song);
 							}
 						}
+
+					} else {
+						if (entries == null)
+							entries = DirectoryWalker.List (dir);
+
+						if (entries == null)
+							continue;
+
+						CheckDirectory (dir, entries);
+
+						state = new DirectoryDatabase.DirectoryState
+						  (mtime, id, entries);
 					}
 
-					if (rq == null)
+					new_states [dir] = state;
+
+					foreach (string subdir in state.Subdirs)
+						pending.Push (Path.Combine (dir, subdir));
+				}
+			}
+
+			// Methods :: Private :: PruneRejects
+			//	Forgets rejected files which were deleted.
+			private void PruneRejects (RejectedFileDatabase reject_db)
+			{
+				string [] paths = reject_db.Paths;
+
+				for (int start = 0; start < paths.Length; start += IoBatchSize) {
+					int n = Math.Min (IoBatchSize, paths.Length - start);
+
+					string [] batch = new string [n];
+					Array.Copy (paths, start, batch, 0, n);
+
+					IoBatch.StatResult [] results = IoBatch.Stat (batch);
+
+					for (int i = 0; i < n; i++) {
+						if (results [i].Error != 0)
+							reject_db.Remove (batch [i]);
+					}
+				}
+			}
+
+			// Methods :: Private :: CheckDirectory
+			//	Checks the songs we have in dir, and queues the
+			//	music files we don't have yet.
+			private void CheckDirectory (string dir, string [] entries)
+			{
+				Hashtable files = new Hashtable ();
+				foreach (string entry in entries) {
+					if (entry [0] == 'f')
+						files [Path.Combine (dir, entry.Substring (1))] = true;
+				}
+
+				ArrayList songs = (ArrayList) songs_by_dir [dir];
+				songs_by_dir.Remove (dir);
+
+				if (songs != null) {
+					foreach (Song song in songs)
+						files.Remove (song.Filename);
+
+					to_check.AddRange (songs);
+				}
+
+				foreach (string file in files.Keys) {
+					// Might have been added meanwhile
+					if (Global.DB.Songs.ContainsKey (file))
 						continue;
 
-					queue.Enqueue (rq);
+					new_files.Add (file);
 				}
+			}
+
+			// Methods :: Private :: CheckSongs
+			//	Checks whether the songs in to_check were removed
+			//	or changed, a batch at a time.
+			private void CheckSongs ()
+			{
+				for (int start = 0; start < to_check.Count; start += IoBatchSize) {
+					int n = Math.Min (IoBatchSize, to_check.Count - start);
+
+					string [] paths = new string [n];
+					for (int i = 0; i < n; i++)
+						paths [i] = ((Song) to_check [start + i]).Filename;
+
+					ImportScheduler.WaitTurn ();
+
+					IoBatch.StatResult [] results = IoBatch.Stat (paths);
 
-				// Check for new songs
-				foreach (string folder in Global.DB.WatchedFolders) {
-					DirectoryInfo dinfo = new DirectoryInfo (folder);
-					if (!dinfo.Exists)
+					ArrayList changed = new ArrayList ();
+					ArrayList changed_paths = new ArrayList ();
+
+					for (int i = 0; i < n; i++) {
+						Song song = (Song) to_check [start + i];
+
+						if (results [i].Error != 0) {
+							missing.Add (song);
+							continue;
+						}
+
+						if (song.MTime < results [i].MTime) {
+							changed.Add (song);
+							changed_paths.Add (song.Filename);
+							continue;
+						}
+
+						if (Global.DB.id_db != null)
+							Global.DB.id_db.Store (song.Filename,
+								FileIdFromStat (results [i]));
+					}
+
+					if (changed.Count == 0)
 						continue;
 
-					BooleanBox canceled = new BooleanBox (false);
-					Global.DB.HandleDirectory (dinfo, queue, canceled);
+					Type string_type = typeof (string);
+					ImportScheduler.WaitTurn ();
+					IoBatch.Prefetch ((string []) changed_paths.ToArray (string_type));
+
+					foreach (Song song in changed)
+						SyncSong (song);
 				}
+			}
+
+			// Methods :: Private :: FindMoves
+			//	Pairs up missing songs with new files which are the
+			//	same file, and moves the songs there.
+			private void FindMoves ()
+			{
+				FileIdDatabase id_db = Global.DB.id_db;
+
+				if (id_db == null || missing.Count == 0 || new_files.Count == 0)
+					return;
 
-				thread_done = true;
+				Hashtable by_id = new Hashtable ();
+				foreach (Song song in missing) {
+					FileIdDatabase.FileId id = id_db [song.Filename];
+					if (id != null)
+						by_id [id.Key] = song;
+				}
+
+				if (by_id.Count == 0)
+					return;
+
+				ArrayList unmatched = new ArrayList ();
+				Hashtable moved = new Hashtable ();
+
+				for (int start = 0; start < new_files.Count; start += IoBatchSize) {
+					int n = Math.Min (IoBatchSize, new_files.Count - start);
+
+					string [] paths = new string [n];
+					new_files.CopyTo (start, paths, 0, n);
+
+					IoBatch.StatResult [] results = IoBatch.Stat (paths);
+
+					for (int i = 0; i < n; i++) {
+						Song song = null;
+						string key = null;
+
+						if (results [i].Error == 0) {
+							key = FileIdFromStat (results [i]).Key;
+							song = (Song) by_id [key];
+						}
+
+						if (song == null) {
+							unmatched.Add (paths [i]);
+							continue;
+						}
+
+						by_id.Remove (key);
+						moved [song] = true;
+
+						try {
+							Enqueue (Global.DB.StartMoveSong (song, paths [i]));
+						} catch (InvalidOperationException) {
+						}
+					}
+				}
+
+				new_files = unmatched;
+
+				ArrayList still_missing = new ArrayList ();
+				foreach (Song song in missing) {
+					if (!moved.ContainsKey (song))
+						still_missing.Add (song);
+				}
+
+				missing = still_missing;
+			}
+
+			// Methods :: Private :: FileIdFromStat
+			private static FileIdDatabase.FileId FileIdFromStat
+			  (IoBatch.StatResult result)
+			{
+				return new FileIdDatabase.FileId (result.Device,
+					result.Inode, result.Size, result.MTime);
+			}
+
+			// Methods :: Private :: SyncSong
+			private void SyncSong (Song song)
+			{
+				Metadata metadata;
+				try {
+					metadata = new Metadata (song.Filename);
+
+				} catch {
+					RemoveSong (song);
+					return;
+				}
+
+				try {
+					Enqueue (Global.DB.StartSyncSong (song, metadata));
+				} catch (InvalidOperationException) {
+				}
+			}
+
+			// Methods :: Private :: RemoveSong
+			private void RemoveSong (Song song)
+			{
+				try {
+					Enqueue (Global.DB.StartRemoveSong (song));
+				} catch (InvalidOperationException) {
+				}
+			}
+
+			// Methods :: Private :: StoreStates
+			private void StoreStates ()
+			{
+				foreach (string path in dir_db.Paths) {
+					if (!new_states.ContainsKey (path))
+						dir_db.Remove (path);
+				}
+
+				foreach (string path in new_states.Keys) {
+					DirectoryDatabase.DirectoryState state =
+					  (DirectoryDatabase.DirectoryState) new_states [path];
+
+					// Unchanged, no need to write it again
+					if (state == dir_db [path])
+						continue;
+
+					dir_db.Store (path, state);
+				}
+			}
+
+			// Delegate Functions :: CommitFunc (ImportPipeline)
+			private void CommitFunc (string filename, Song song)
+			{
+				try {
+					Enqueue (Global.DB.StartAddSong (song));
+				} catch (InvalidOperationException) {
+				}
 			}
 		}
 	}
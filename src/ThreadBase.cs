@@ -23,34 +23,237 @@ using System.Threading;
 
 namespace Muine
 {
+	/// <summary>
+	///	A worker thread which hands items to the main loop.
+	/// </summary>
+	/// <remarks>
+	///	The main loop is only woken up when items were queued with
+	///	<see cref="Enqueue" />, or when the thread is done. It then
+	///	handles as many items as fit in <see cref="FrameBudget" />,
+	///	and comes back for the rest after the next frame.
+	/// </remarks>
 	public abstract class ThreadBase
 	{
+		// GConf
+		private const string GConfKeyFrameBudget = "/apps/muine/main_loop_budget";
+		private const int GConfDefaultFrameBudget = 10;
+
 		// Objects
 		protected Thread thread;
 		protected Queue queue;
 
-		// Variables				
+		// Variables
 		protected bool thread_done = false;
 
+		private bool scheduled = false;
+		private bool finished  = false;
+		private int frame_budget;
+
+		private int n_handled = 0;
+		private TimeSpan main_loop_time = TimeSpan.Zero;
+		private DateTime start_time;
+
 		// Constructor
 		public ThreadBase ()
 		{
 			queue = Queue.Synchronized (new Queue ());
 
-			GLib.IdleHandler idle = new GLib.IdleHandler (MainLoopIdle);
-			GLib.Idle.Add (idle);
+			frame_budget = (int) Config.Get (GConfKeyFrameBudget,
+				GConfDefaultFrameBudget);
+
+			start_time = DateTime.Now;
 
-			thread = new Thread (new ThreadStart (ThreadFunc));
+			thread = new Thread (new ThreadStart (Run));
 			thread.IsBackground = true;
 			thread.Priority = ThreadPriority.BelowNormal;
 		}
 
+		// Properties
+		// Properties :: FrameBudget (set; get;)
+		/// <summary>
+		///	Milliseconds of main loop time spent handling items
+		///	before giving the main loop back.
+		/// </summary>
+		public int FrameBudget {
+			set { frame_budget = Math.Max (1, value); }
+			get { return frame_budget; }
+		}
+
+		// Properties :: NHandled (get;)
+		/// <summary>
+		///	The number of items handled so far.
+		/// </summary>
+		public int NHandled {
+			get { return n_handled; }
+		}
+
+		// Properties :: DrainRate (get;)
+		/// <summary>
+		///	The number of items handled per second since the
+		///	thread was created.
+		/// </summary>
+		public double DrainRate {
+			get {
+				TimeSpan elapsed = DateTime.Now - start_time;
+				if (elapsed.TotalSeconds <= 0)
+					return 0;
+
+				return n_handled / elapsed.TotalSeconds;
+			}
+		}
+
+		// Properties :: MainLoopTime (get;)
+		/// <summary>
+		///	The time spent in the main loop handling items.
+		/// </summary>
+		public TimeSpan MainLoopTime {
+			get { return main_loop_time; }
+		}
+
 		// Methods
+		// Methods :: Protected
+		// Methods :: Protected :: Enqueue
+		/// <summary>
+		///	Queue an item for <see cref="HandleItem" />, and wake
+		///	up the main loop. Can be called from any thread.
+		/// </summary>
+		protected void Enqueue (object item)
+		{
+			queue.Enqueue (item);
+
+			Wake ();
+		}
+
 		// Methods :: Abstract
 		// Methods :: Abstract :: ThreadFunc
 		protected abstract void ThreadFunc ();
 
-		// Methods :: Abstract :: MainLoopIdle
-		protected abstract bool MainLoopIdle ();
+		// Methods :: Abstract :: HandleItem
+		/// <summary>
+		///	Called from the main loop for every queued item.
+		/// </summary>
+		protected abstract void HandleItem (object item);
+
+		// Methods :: Virtual
+		// Methods :: Virtual :: BatchStarted
+		/// <summary>
+		///	Called from the main loop before a batch of items is
+		///	handled.
+		/// </summary>
+		protected virtual void BatchStarted ()
+		{
+		}
+
+		// Methods :: Virtual :: BatchFinished
+		/// <summary>
+		///	Called from the main loop after a batch of items was
+		///	handled.
+		/// </summary>
+		protected virtual void BatchFinished ()
+		{
+		}
+
+		// Methods :: Virtual :: Finished
+		/// <summary>
+		///	Called from the main loop once, after the thread is done
+		///	and every item has been handled.
+		/// </summary>
+		protected virtual void Finished ()
+		{
+		}
+
+		// Methods :: Private
+		// Methods :: Private :: Wake
+		private void Wake ()
+		{
+			lock (queue.SyncRoot) {
+				if (scheduled)
+					return;
+
+				scheduled = true;
+			}
+
+			GLib.Idle.Add (new GLib.IdleHandler (Dispatch));
+		}
+
+		// Delegate Functions
+		// Delegate Functions :: Run (ThreadStart)
+		private void Run ()
+		{
+			try {
+				ThreadFunc ();
+
+			} finally {
+				lock (queue.SyncRoot)
+					thread_done = true;
+
+				Wake ();
+			}
+		}
+
+		// Delegate Functions :: Dispatch (GLib.IdleHandler)
+		/// <summary>
+		///	Handles queued items until the queue is empty or the
+		///	frame budget is spent.
+		/// </summary>
+		/// <returns>
+		///	True to be called again for the rest.
+		/// </returns>
+		private bool Dispatch ()
+		{
+			DateTime start = DateTime.Now;
+			int n = 0;
+
+			while (true) {
+				object item;
+
+				lock (queue.SyncRoot) {
+					if (queue.Count == 0)
+						break;
+
+					item = queue.Dequeue ();
+				}
+
+				if (n == 0)
+					BatchStarted ();
+
+				HandleItem (item);
+				n ++;
+
+				TimeSpan spent = DateTime.Now - start;
+				if (spent.TotalMilliseconds >= frame_budget)
+					break;
+			}
+
+			if (n > 0)
+				BatchFinished ();
+
+			n_handled += n;
+			main_loop_time += DateTime.Now - start;
+
+			bool finish = false;
+
+			lock (queue.SyncRoot) {
+				if (queue.Count > 0)
+					return true;
+
+				scheduled = false;
+
+				if (thread_done && !finished) {
+					finished = true;
+					finish = true;
+				}
+			}
+
+			if (finish) {
+				DebugLog.Write ("{0}: {1} items, {2:0.0} per second, " +
+					"{3:0} ms in the main loop", GetType ().Name,
+					NHandled, DrainRate, MainLoopTime.TotalMilliseconds);
+
+				Finished ();
+			}
+
+			return false;
+		}
 	}
 }
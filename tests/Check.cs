@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+
+namespace Muine.Tests
+{
+	/// <summary>
+	///	Collects the outcome of a test program's checks.
+	/// </summary>
+	public static class Check
+	{
+		// Variables
+		private static int n_checks   = 0;
+		private static int n_failures = 0;
+
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: That
+		public static void That (bool condition, string format,
+					 params object [] args)
+		{
+			n_checks ++;
+
+			if (condition)
+				return;
+
+			n_failures ++;
+
+			Console.Error.WriteLine ("FAIL: " + format, args);
+		}
+
+		// Methods :: Public :: Result
+		/// <summary>
+		///	Report the outcome.
+		/// </summary>
+		/// <returns>
+		///	The exit code for the test program: 0 if every
+		///	check passed, 1 otherwise.
+		/// </returns>
+		public static int Result (string name)
+		{
+			Console.WriteLine ("{0}: {1} checks, {2} failed",
+				name, n_checks, n_failures);
+
+			return (n_failures == 0) ? 0 : 1;
+		}
+	}
+}
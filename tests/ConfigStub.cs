@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+
+namespace Muine
+{
+	/// <summary>
+	///	Stands in for the GConf-backed <see cref="Config" /> in
+	///	the tests, so every key has its default value.
+	/// </summary>
+	public static class Config
+	{
+		// Methods
+		// Methods :: Public
+		// Methods :: Public :: Get
+		public static object Get (string key, object default_val)
+		{
+			return default_val;
+		}
+	}
+}
@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+
+namespace Muine.Tests
+{
+	/// <summary>
+	///	Runs <see cref="CoverFetchPool" /> jobs against a local HTTP
+	///	server and checks the per-host limits, the interval between
+	///	job starts and the backoff after a failure.
+	/// </summary>
+	/// <remarks>
+	///	Every job's URL is /host/name on the same server; the pool
+	///	only knows hosts by <see cref="CoverFetchPool.Job.Host" />.
+	///	Names starting with "slow" take a while to answer, those
+	///	starting with "fail-once" fail with 503 the first time.
+	/// </remarks>
+	public class CoverFetchPoolTest
+	{
+		// Constants
+		private const int SlowMs = 300;
+
+		//	CoverFetchPool waits 5 seconds after the first failure,
+		//	give or take 50%
+		private const double MinBackoff = 2.5;
+		private const double MaxBackoff = 7.5;
+
+		// Objects
+		private static StubServer server;
+		private static CoverFetchPool pool;
+
+		// Variables
+		private static int n_done = 0;
+
+		// Main
+		public static int Main (string [] args)
+		{
+			server = new StubServer ();
+
+			// Keep the client from being the bottleneck
+			ServicePointManager.DefaultConnectionLimit = 16;
+
+			pool = new CoverFetchPool ();
+
+			TestPerHostLimit ();
+			TestSetHostLimits ();
+			TestMinInterval ();
+			TestBackoff ();
+
+			server.Stop ();
+
+			return Check.Result ("cover-fetch-pool-test");
+		}
+
+		// Tests
+		// Tests :: PerHostLimit
+		//	cover_fetch_per_host defaults to 2
+		private static void TestPerHostLimit ()
+		{
+			Run ("a", "slow", 6);
+
+			Check.That (server.MaxActive ("a") == 2,
+				"host a: {0} requests at once, expected 2",
+				server.MaxActive ("a"));
+		}
+
+		// Tests :: SetHostLimits
+		private static void TestSetHostLimits ()
+		{
+			pool.SetHostLimits ("b", 1, 0);
+
+			Run ("b", "slow", 3);
+
+			Check.That (server.MaxActive ("b") == 1,
+				"host b: {0} requests at once, expected 1",
+				server.MaxActive ("b"));
+		}
+
+		// Tests :: MinInterval
+		private static void TestMinInterval ()
+		{
+			pool.SetHostLimits ("c", 2, 0.5);
+
+			Run ("c", "ok", 3);
+
+			ArrayList starts = server.Starts ("c");
+			starts.Sort ();
+
+			for (int i = 1; i < starts.Count; i ++) {
+				double gap = Seconds ((DateTime) starts [i - 1],
+						      (DateTime) starts [i]);
+
+				Check.That (gap >= 0.45,
+					"host c: jobs started {0:0.00}s apart, " +
+					"expected at least 0.5s", gap);
+			}
+		}
+
+		// Tests :: Backoff
+		//	After a failure, neither the failed job nor any other
+		//	job for the host runs until the backoff is over.
+		private static void TestBackoff ()
+		{
+			int n = n_done;
+
+			pool.Add (new StubJob ("d", "fail-once"));
+
+			WaitFor (delegate { return server.Starts ("d").Count >= 1; });
+
+			// Give the worker time to record the failure
+			Thread.Sleep (100);
+
+			pool.Add (new StubJob ("d", "ok"));
+
+			WaitFor (delegate { return n_done >= n + 2; });
+
+			DateTime failed_at = server.FirstStart ("d", "fail-once");
+
+			DateTime retried_at = server.LastStart ("d", "fail-once");
+			DateTime other_at = server.FirstStart ("d", "ok");
+
+			double retry = Seconds (failed_at, retried_at);
+			double other = Seconds (failed_at, other_at);
+
+			Check.That (retry >= MinBackoff - 0.1 && retry <= MaxBackoff + 1,
+				"host d: failed job retried after {0:0.00}s, " +
+				"expected {1}s to {2}s", retry, MinBackoff, MaxBackoff);
+
+			Check.That (other >= MinBackoff - 0.1,
+				"host d: other job started {0:0.00}s after the " +
+				"failure, expected at least {1}s", other, MinBackoff);
+
+			Check.That (n_done == n + 2,
+				"host d: {0} jobs finished, expected 2", n_done - n);
+		}
+
+		// Methods
+		// Methods :: Private
+		// Methods :: Private :: Run
+		//	Runs jobs for one host and waits for them to finish
+		private static void Run (string host, string name, int count)
+		{
+			int n = n_done;
+
+			for (int i = 0; i < count; i ++)
+				pool.Add (new StubJob (host, name + "-" + i));
+
+			WaitFor (delegate { return n_done >= n + count; });
+
+			Check.That (n_done == n + count,
+				"host {0}: {1} of {2} jobs finished",
+				host, n_done - n, count);
+		}
+
+		// Methods :: Private :: WaitFor
+		private delegate bool Condition ();
+
+		private static void WaitFor (Condition condition)
+		{
+			DateTime give_up = DateTime.Now.AddSeconds (30);
+
+			lock (typeof (CoverFetchPoolTest)) {
+				while (!condition () && DateTime.Now < give_up)
+					Monitor.Wait (typeof (CoverFetchPoolTest), 100);
+			}
+		}
+
+		// Methods :: Private :: Seconds
+		private static double Seconds (DateTime from, DateTime to)
+		{
+			return (to - from).TotalSeconds;
+		}
+
+		// Internal Classes
+		// Internal Classes :: StubJob
+		private class StubJob : CoverFetchPool.Job
+		{
+			private string host;
+			private string url;
+
+			public StubJob (string host, string name)
+			{
+				this.host = host;
+				this.url = server.Prefix + host + "/" + name;
+			}
+
+			public override string Host {
+				get { return host; }
+			}
+
+			public override void Run ()
+			{
+				WebRequest req = WebRequest.Create (url);
+				req.Timeout = 10000;
+
+				// Throws WebException on 503
+				req.GetResponse ().Close ();
+
+				lock (typeof (CoverFetchPoolTest)) {
+					n_done ++;
+					Monitor.PulseAll (typeof (CoverFetchPoolTest));
+				}
+			}
+		}
+
+		// Internal Classes :: StubServer
+		private class StubServer
+		{
+			private HttpListener listener = new HttpListener ();
+
+			//	Host => ArrayList of Request
+			private Hashtable requests = new Hashtable ();
+
+			//	Host => int
+			private Hashtable active     = new Hashtable ();
+			private Hashtable max_active = new Hashtable ();
+
+			public string Prefix;
+
+			public StubServer ()
+			{
+				// Find a free port
+				TcpListener tcp = new TcpListener (IPAddress.Loopback, 0);
+				tcp.Start ();
+				int port = ((IPEndPoint) tcp.LocalEndpoint).Port;
+				tcp.Stop ();
+
+				Prefix = String.Format ("http://127.0.0.1:{0}/", port);
+
+				listener.Prefixes.Add (Prefix);
+				listener.Start ();
+
+				Thread thread = new Thread (new ThreadStart (AcceptFunc));
+				thread.IsBackground = true;
+				thread.Start ();
+			}
+
+			public void Stop ()
+			{
+				listener.Close ();
+			}
+
+			public int MaxActive (string host)
+			{
+				lock (this) {
+					object max = max_active [host];
+
+					return (max != null) ? (int) max : 0;
+				}
+			}
+
+			public ArrayList Starts (string host)
+			{
+				ArrayList starts = new ArrayList ();
+
+				lock (this) {
+					ArrayList list = (ArrayList) requests [host];
+					if (list == null)
+						return starts;
+
+					foreach (Request r in list)
+						starts.Add (r.Start);
+				}
+
+				return starts;
+			}
+
+			public DateTime FirstStart (string host, string name)
+			{
+				lock (this) {
+					foreach (Request r in (ArrayList) requests [host]) {
+						if (r.Name == name)
+							return r.Start;
+					}
+				}
+
+				return DateTime.MaxValue;
+			}
+
+			public DateTime LastStart (string host, string name)
+			{
+				DateTime last = DateTime.MinValue;
+
+				lock (this) {
+					foreach (Request r in (ArrayList) requests [host]) {
+						if (r.Name == name)
+							last = r.Start;
+					}
+				}
+
+				return last;
+			}
+
+			private void AcceptFunc ()
+			{
+				while (true) {
+					HttpListenerContext context;
+
+					try {
+						context = listener.GetContext ();
+					} catch (Exception) {
+						return;
+					}
+
+					ThreadPool.QueueUserWorkItem (new WaitCallback (HandleFunc),
+						context);
+				}
+			}
+
+			private void HandleFunc (object o)
+			{
+				HttpListenerContext context = (HttpListenerContext) o;
+
+				string [] parts = context.Request.Url.AbsolutePath.Split ('/');
+				string host = parts [1];
+				string name = parts [2];
+
+				bool first;
+
+				lock (this) {
+					ArrayList list = (ArrayList) requests [host];
+					if (list == null) {
+						list = new ArrayList ();
+						requests [host] = list;
+					}
+
+					first = (FirstStart (host, name) == DateTime.MaxValue);
+
+					list.Add (new Request (name, DateTime.Now));
+
+					int n = (active [host] != null) ? (int) active [host] : 0;
+					n ++;
+					active [host] = n;
+
+					if (n > MaxActive (host))
+						max_active [host] = n;
+				}
+
+				if (name.StartsWith ("slow"))
+					Thread.Sleep (SlowMs);
+
+				lock (this)
+					active [host] = (int) active [host] - 1;
+
+				HttpListenerResponse response = context.Response;
+
+				if (name.StartsWith ("fail-once") && first)
+					response.StatusCode = 503;
+
+				response.ContentLength64 = 0;
+				response.Close ();
+			}
+		}
+
+		// Internal Classes :: Request
+		private class Request
+		{
+			public string   Name;
+			public DateTime Start;
+
+			public Request (string name, DateTime start)
+			{
+				Name  = name;
+				Start = start;
+			}
+		}
+	}
+}
@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.IO;
+using System.Threading;
+
+namespace Muine.Tests
+{
+	/// <summary>
+	///	Stores recorded responses in a <see cref="ResponseCache" />
+	///	and reads them back, and checks how Amazon search pages are
+	///	kept in it with <see cref="AmazonSearchPage" />.
+	/// </summary>
+	/// <remarks>
+	///	The fixtures are a search page as SearchAmazon caches it,
+	///	and one of the images in data/images standing in for a
+	///	downloaded cover.
+	/// </remarks>
+	public class ResponseCacheTest
+	{
+		// Constants
+		private const string PageKey  = "amazon\tus\tthe beatles\tabbey road\t1";
+		private const string ImageKey = "http://images.amazon.com/images/P/B000002UB3.01.MZZZZZZZ.jpg";
+
+		// Variables
+		private static string srcdir;
+		private static string directory;
+
+		private static string page_fixture;
+		private static byte [] image_fixture;
+
+		// Main
+		public static int Main (string [] args)
+		{
+			srcdir = Environment.GetEnvironmentVariable ("srcdir");
+			if (srcdir == null)
+				srcdir = ".";
+
+			// Editors like to end the file with a newline; the
+			// cached page doesn't
+			page_fixture = File.ReadAllText (Fixture ("fixtures/amazon-search-page.txt"));
+			page_fixture = page_fixture.TrimEnd ('\n');
+
+			image_fixture = File.ReadAllBytes (Fixture ("../data/images/muine-default-cover.png"));
+
+			directory = Path.Combine (Path.GetTempPath (),
+				"muine-response-cache-test-" + Guid.NewGuid ().ToString ("N"));
+
+			try {
+				TestRoundTrip ();
+				TestPersistence ();
+				TestRemove ();
+				TestOversized ();
+				TestEviction ();
+				TestLeftoverTemp ();
+				TestParsePage ();
+				TestStoreSearchPage ();
+				TestMalformedPage ();
+
+			} finally {
+				if (Directory.Exists (directory))
+					Directory.Delete (directory, true);
+			}
+
+			return Check.Result ("response-cache-test");
+		}
+
+		// Tests
+		// Tests :: RoundTrip
+		private static void TestRoundTrip ()
+		{
+			ResponseCache cache = NewCache (1024 * 1024);
+
+			Check.That (cache.Get (ImageKey) == null,
+				"round trip: empty cache has the image");
+
+			cache.Put (ImageKey, image_fixture);
+			cache.PutString (PageKey, page_fixture);
+
+			Check.That (Same (cache.Get (ImageKey), image_fixture),
+				"round trip: image differs");
+
+			Check.That (cache.GetString (PageKey) == page_fixture,
+				"round trip: search page differs");
+
+			Check.That (cache.NHits == 2 && cache.NMisses == 1,
+				"round trip: {0} hits and {1} misses, expected 2 and 1",
+				cache.NHits, cache.NMisses);
+		}
+
+		// Tests :: Persistence
+		//	Responses are found again by a new cache, as in the
+		//	next session.
+		private static void TestPersistence ()
+		{
+			ResponseCache cache = new ResponseCache (directory, 1024 * 1024);
+
+			Check.That (Same (cache.Get (ImageKey), image_fixture),
+				"persistence: image not found in the next session");
+
+			Check.That (cache.GetString (PageKey) == page_fixture,
+				"persistence: search page not found in the next session");
+		}
+
+		// Tests :: Remove
+		private static void TestRemove ()
+		{
+			ResponseCache cache = NewCache (1024 * 1024);
+
+			cache.Put (ImageKey, image_fixture);
+			cache.Remove (ImageKey);
+
+			Check.That (cache.Get (ImageKey) == null,
+				"remove: image still there");
+
+			Check.That (Directory.GetFiles (directory).Length == 0,
+				"remove: {0} files left", Directory.GetFiles (directory).Length);
+		}
+
+		// Tests :: Oversized
+		private static void TestOversized ()
+		{
+			ResponseCache cache = NewCache (image_fixture.Length - 1);
+
+			cache.Put (ImageKey, image_fixture);
+
+			Check.That (cache.Get (ImageKey) == null,
+				"oversized: response larger than the budget was kept");
+		}
+
+		// Tests :: Eviction
+		//	With room for two and a half responses, storing a
+		//	third one deletes the one used least recently; the
+		//	other two still fit in the 90% that's kept.
+		private static void TestEviction ()
+		{
+			ResponseCache cache = NewCache (image_fixture.Length * 5 / 2);
+
+			cache.Put ("a", image_fixture);
+			Wait ();
+			cache.Put ("b", image_fixture);
+			Wait ();
+
+			// Used, so b is now the oldest
+			cache.Get ("a");
+			Wait ();
+
+			cache.Put ("c", image_fixture);
+
+			Check.That (cache.Get ("a") != null,
+				"eviction: recently used response was deleted");
+			Check.That (cache.Get ("b") == null,
+				"eviction: least recently used response was kept");
+			Check.That (cache.Get ("c") != null,
+				"eviction: new response was deleted");
+		}
+
+		// Tests :: LeftoverTemp
+		//	A response which was being written during a crash is
+		//	deleted, and not counted against the budget.
+		private static void TestLeftoverTemp ()
+		{
+			NewCache (0);
+
+			Directory.CreateDirectory (directory);
+
+			string temp = Path.Combine (directory, "0123456789abcdef.tmp");
+			File.WriteAllBytes (temp, image_fixture);
+
+			ResponseCache cache = new ResponseCache (directory,
+				image_fixture.Length);
+
+			cache.Put (ImageKey, image_fixture);
+
+			Check.That (!File.Exists (temp),
+				"leftover: temporary file not deleted");
+			Check.That (Same (cache.Get (ImageKey), image_fixture),
+				"leftover: image was evicted");
+		}
+
+		// Tests :: ParsePage
+		private static void TestParsePage ()
+		{
+			AmazonSearchPage page = AmazonSearchPage.Parse (page_fixture);
+
+			Check.That (page != null, "parse: recorded page not parsed");
+			if (page == null)
+				return;
+
+			Check.That (page.TotalPages == 2,
+				"parse: {0} pages, expected 2", page.TotalPages);
+
+			Check.That (page.ProductNames.Length == 4 &&
+				    page.ImageUrls.Length == 4,
+				"parse: {0} products, expected 4",
+				page.ProductNames.Length);
+
+			if (page.ProductNames.Length != 4)
+				return;
+
+			Check.That (page.ProductNames [1] == "Abbey Road",
+				"parse: product 1 is \"{0}\"", page.ProductNames [1]);
+
+			Check.That (page.ImageUrls [1] == ImageKey,
+				"parse: image 1 is \"{0}\"", page.ImageUrls [1]);
+
+			Check.That (page.ImageUrls [2] == String.Empty,
+				"parse: product without image has \"{0}\"",
+				page.ImageUrls [2]);
+
+			Check.That (page.ToString () == page_fixture,
+				"parse: page isn't written back the same");
+		}
+
+		// Tests :: StoreSearchPage
+		//	Names and URLs from Amazon may hold the separators,
+		//	and may be missing.
+		private static void TestStoreSearchPage ()
+		{
+			AmazonSearchPage page = new AmazonSearchPage (1,
+				new string [] { "Help!\t[Remastered]", "Rubber\nSoul" },
+				new string [] { null, ImageKey });
+
+			ResponseCache cache = NewCache (1024 * 1024);
+			cache.PutString (PageKey, page.ToString ());
+
+			AmazonSearchPage cached =
+			  AmazonSearchPage.Parse (cache.GetString (PageKey));
+
+			Check.That (cached != null && cached.ProductNames.Length == 2,
+				"store: page not read back");
+			if (cached == null || cached.ProductNames.Length != 2)
+				return;
+
+			Check.That (cached.ProductNames [0] == "Help! [Remastered]" &&
+				    cached.ProductNames [1] == "Rubber Soul",
+				"store: names are \"{0}\" and \"{1}\"",
+				cached.ProductNames [0], cached.ProductNames [1]);
+
+			Check.That (cached.ImageUrls [0] == String.Empty &&
+				    cached.ImageUrls [1] == ImageKey,
+				"store: images are \"{0}\" and \"{1}\"",
+				cached.ImageUrls [0], cached.ImageUrls [1]);
+		}
+
+		// Tests :: MalformedPage
+		//	A damaged entry is a miss, not an error
+		private static void TestMalformedPage ()
+		{
+			Check.That (AmazonSearchPage.Parse ("<html>503</html>") == null,
+				"malformed: page without a page count parsed");
+
+			Check.That (AmazonSearchPage.Parse (String.Empty) == null,
+				"malformed: empty page parsed");
+		}
+
+		// Methods
+		// Methods :: Private
+		// Methods :: Private :: NewCache
+		//	An empty cache
+		private static ResponseCache NewCache (long budget)
+		{
+			if (Directory.Exists (directory))
+				Directory.Delete (directory, true);
+
+			return new ResponseCache (directory, budget);
+		}
+
+		// Methods :: Private :: Fixture
+		private static string Fixture (string name)
+		{
+			return Path.Combine (srcdir, name);
+		}
+
+		// Methods :: Private :: Same
+		private static bool Same (byte [] a, byte [] b)
+		{
+			if (a == null || b == null || a.Length != b.Length)
+				return false;
+
+			for (int i = 0; i < a.Length; i ++) {
+				if (a [i] != b [i])
+					return false;
+			}
+
+			return true;
+		}
+
+		// Methods :: Private :: Wait
+		//	Long enough for the mtimes to differ on any file system
+		private static void Wait ()
+		{
+			Thread.Sleep (1100);
+		}
+	}
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+using System;
+using System.Collections;
+using System.Globalization;
+
+namespace Muine.Tests
+{
+	/// <summary>
+	///	Checks the batched events of <see cref="SignalBatch" />,
+	///	in particular that songs removed during a batch can still
+	///	be found by their handles when SongsRemoved is emitted, as
+	///	the playlist needs to unregister its extra handles.
+	/// </summary>
+	public class SignalBatchTest
+	{
+		// Main
+		public static int Main (string [] args)
+		{
+			TestRemovePlaylistSong ();
+			TestAddedAndRemoved ();
+			TestChangedAndRemoved ();
+			TestOrder ();
+
+			return Check.Result ("signal-batch-test");
+		}
+
+		// Tests
+		// Tests :: RemovePlaylistSong
+		//	Like PlaylistWindow.RemoveSongs: the song is in the
+		//	playlist twice, once with an extra handle.
+		private static void TestRemovePlaylistSong ()
+		{
+			FakeItem song = new FakeItem ("song");
+			IntPtr extra = song.RegisterHandle ();
+
+			IntPtr [] playlist = new IntPtr [] { song.Handle, extra };
+
+			SignalBatch batch = NewBatch ();
+			batch.RemoveSong (song);
+			batch.Deregister (song);
+
+			bool found = true;
+			int n_removed = 0;
+
+			batch.Finish (delegate (SignalBatch.Signal signal, Array items) {
+				if (signal != SignalBatch.Signal.SongsRemoved)
+					return;
+
+				n_removed += items.Length;
+
+				foreach (IntPtr h in playlist) {
+					if (FakeItem.FromHandle (h) == null)
+						found = false;
+				}
+			});
+
+			Check.That (n_removed == 1,
+				"playlist song: {0} songs removed, expected 1", n_removed);
+
+			Check.That (found,
+				"playlist song: handles gone before SongsRemoved");
+
+			Check.That (FakeItem.FromHandle (song.Handle) == null &&
+				    FakeItem.FromHandle (extra) == null,
+				"playlist song: handles still there after the batch");
+		}
+
+		// Tests :: AddedAndRemoved
+		private static void TestAddedAndRemoved ()
+		{
+			FakeItem song = new FakeItem ("song");
+			FakeItem album = new FakeItem ("album");
+
+			SignalBatch batch = NewBatch ();
+			batch.AddSong (song);
+			batch.AddAlbum (album);
+			batch.ChangeSong (song);
+			batch.RemoveSong (song);
+			batch.RemoveAlbum (album);
+			batch.Deregister (song);
+			batch.Deregister (album);
+
+			ArrayList signals = Record (batch);
+
+			Check.That (signals.Count == 0,
+				"added and removed: {0} events, expected none",
+				signals.Count);
+
+			Check.That (FakeItem.FromHandle (song.Handle) == null &&
+				    FakeItem.FromHandle (album.Handle) == null,
+				"added and removed: not deregistered");
+		}
+
+		// Tests :: ChangedAndRemoved
+		private static void TestChangedAndRemoved ()
+		{
+			FakeItem song = new FakeItem ("song");
+
+			SignalBatch batch = NewBatch ();
+			batch.ChangeSong (song);
+			batch.ChangeSong (song);
+			batch.RemoveSong (song);
+
+			ArrayList signals = Record (batch);
+
+			Check.That (signals.Count == 1 &&
+				    (SignalBatch.Signal) signals [0] == SignalBatch.Signal.SongsRemoved,
+				"changed and removed: expected only SongsRemoved");
+		}
+
+		// Tests :: Order
+		//	Every event once, with each item once, in order
+		private static void TestOrder ()
+		{
+			FakeItem a = new FakeItem ("a");
+			FakeItem b = new FakeItem ("b");
+
+			SignalBatch batch = NewBatch ();
+			batch.RemoveAlbum (b);
+			batch.RemoveSong (a);
+			batch.ChangeAlbum (a);
+			batch.ChangeSong (b);
+			batch.AddAlbum (a);
+			batch.AddSong (b);
+			batch.AddSong (b);
+
+			int n_items = 0;
+			ArrayList signals = new ArrayList ();
+
+			batch.Finish (delegate (SignalBatch.Signal signal, Array items) {
+				signals.Add (signal);
+				n_items += items.Length;
+
+				Check.That (items is FakeItem [],
+					"order: {0} has the wrong array type", signal);
+			});
+
+			Check.That (signals.Count == 6 && n_items == 6,
+				"order: {0} events with {1} items, expected 6 and 6",
+				signals.Count, n_items);
+
+			for (int i = 0; i < signals.Count; i ++) {
+				Check.That ((int) signals [i] == i,
+					"order: event {0} is {1}", i, signals [i]);
+			}
+		}
+
+		// Methods
+		// Methods :: Private
+		// Methods :: Private :: NewBatch
+		private static SignalBatch NewBatch ()
+		{
+			return new SignalBatch (typeof (FakeItem), typeof (FakeItem));
+		}
+
+		// Methods :: Private :: Record
+		private static ArrayList Record (SignalBatch batch)
+		{
+			ArrayList signals = new ArrayList ();
+
+			batch.Finish (delegate (SignalBatch.Signal signal, Array items) {
+				signals.Add (signal);
+			});
+
+			return signals;
+		}
+
+		// Internal Classes
+		// Internal Classes :: FakeItem
+		//	Registers its handles like Song does
+		private class FakeItem : Item
+		{
+			private static Hashtable pointers = new Hashtable ();
+			private static int cur_ptr = 0;
+
+			private ArrayList handles = new ArrayList ();
+			private string name;
+
+			public FakeItem (string name)
+			{
+				this.name = name;
+				handle = RegisterHandle ();
+			}
+
+			public static FakeItem FromHandle (IntPtr handle)
+			{
+				return (FakeItem) pointers [handle];
+			}
+
+			public IntPtr RegisterHandle ()
+			{
+				IntPtr ptr = new IntPtr (++ cur_ptr);
+
+				pointers [ptr] = this;
+				handles.Add (ptr);
+
+				return ptr;
+			}
+
+			public override Gdk.Pixbuf CoverImage {
+				get { return null; }
+			}
+
+			public override bool Public {
+				get { return true; }
+			}
+
+			public override void Deregister ()
+			{
+				foreach (IntPtr ptr in handles)
+					pointers.Remove (ptr);
+			}
+
+			public override void EmitCoverChanged ()
+			{
+			}
+
+			protected override SortKey GenerateSortKey ()
+			{
+				return CultureInfo.InvariantCulture.CompareInfo.GetSortKey (name);
+			}
+
+			protected override string GenerateSearchKey ()
+			{
+				return name;
+			}
+		}
+	}
+}
@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Decodes a large JPEG cover the way covers used to be loaded, at full
+ * size and then scaled down, and the way PixbufUtils.LoadAtSize loads
+ * them, with the size set on the loader from size-prepared. Each way
+ * runs in a child process of its own, so its peak memory can be read
+ * from the rusage of the child. Prints the peak memory over that of a
+ * child which decodes nothing and the time per cover, and checks that
+ * both come out at the cover size and that decoding at size peaks
+ * lower.
+ *
+ * Exits with 77, which automake counts as skipped, if gdk-pixbuf can't
+ * save JPEG.
+ */
+
+#include <config.h>
+
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#include "macros.h"
+
+#define EXIT_SKIP 77
+
+/* CoverGetter.TargetSize */
+#define TARGET_SIZE (66 - 2)
+
+/* A scan from an online shop, which is the worst case */
+#define IMAGE_WIDTH  3000
+#define IMAGE_HEIGHT 2800
+
+#define N_DECODES 20
+
+/* PixbufUtils.ChunkSize */
+#define CHUNK_SIZE 16384
+
+typedef GdkPixbuf *(*DecodeFunc) (const char *filename);
+
+typedef struct {
+	const char *name;
+	DecodeFunc decode;
+} Method;
+
+static int n_failures = 0;
+
+static void
+check (gboolean condition, const char *message)
+{
+	if (condition)
+		return;
+
+	n_failures++;
+
+	fprintf (stderr, "FAIL: %s\n", message);
+}
+
+static void
+fit (int *width, int *height)
+{
+	if (*width <= TARGET_SIZE && *height <= TARGET_SIZE)
+		return;
+
+	if (*height > *width) {
+		*width = MAX (1, (int) (TARGET_SIZE * (double) *width / *height + 0.5));
+		*height = TARGET_SIZE;
+	} else {
+		*height = MAX (1, (int) (TARGET_SIZE * (double) *height / *width + 0.5));
+		*width = TARGET_SIZE;
+	}
+}
+
+/* new Pixbuf (file), then the scaling in CoverGetter.AddBorder */
+static GdkPixbuf *
+decode_full (const char *filename)
+{
+	GdkPixbuf *image, *cover;
+	int width, height;
+
+	image = gdk_pixbuf_new_from_file (filename, NULL);
+	if (image == NULL)
+		return NULL;
+
+	width = gdk_pixbuf_get_width (image);
+	height = gdk_pixbuf_get_height (image);
+	fit (&width, &height);
+
+	cover = gdk_pixbuf_scale_simple (image, width, height,
+					 GDK_INTERP_BILINEAR);
+	g_object_unref (image);
+
+	return cover;
+}
+
+static void
+size_prepared_cb (GdkPixbufLoader *loader, int width, int height,
+		  gpointer UNUSED(data))
+{
+	if (width <= TARGET_SIZE && height <= TARGET_SIZE)
+		return;
+
+	fit (&width, &height);
+
+	gdk_pixbuf_loader_set_size (loader, width, height);
+}
+
+/* PixbufUtils.LoadAtSize */
+static GdkPixbuf *
+decode_at_size (const char *filename)
+{
+	GdkPixbufLoader *loader;
+	GdkPixbuf *cover = NULL;
+	guint8 buf[CHUNK_SIZE];
+	FILE *file;
+	size_t n;
+	gboolean ok = TRUE;
+
+	file = fopen (filename, "rb");
+	if (file == NULL)
+		return NULL;
+
+	loader = gdk_pixbuf_loader_new ();
+	g_signal_connect (loader, "size-prepared",
+			  G_CALLBACK (size_prepared_cb), NULL);
+
+	while (ok && (n = fread (buf, 1, sizeof (buf), file)) > 0)
+		ok = gdk_pixbuf_loader_write (loader, buf, n, NULL);
+
+	fclose (file);
+
+	if (gdk_pixbuf_loader_close (loader, NULL) && ok) {
+		cover = gdk_pixbuf_loader_get_pixbuf (loader);
+		if (cover)
+			g_object_ref (cover);
+	}
+
+	g_object_unref (loader);
+
+	return cover;
+}
+
+static GdkPixbuf *
+decode_nothing (const char *UNUSED(filename))
+{
+	return NULL;
+}
+
+static const Method methods[] = {
+	{ "nothing", decode_nothing },
+	{ "full",    decode_full    },
+	{ "at size", decode_at_size }
+};
+
+static gboolean
+write_image (const char *filename)
+{
+	GdkPixbuf *image;
+	GRand *rand;
+	gboolean ok;
+	int x, y;
+
+	image = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8,
+				IMAGE_WIDTH, IMAGE_HEIGHT);
+
+	/* Same pixels every run */
+	rand = g_rand_new_with_seed (43);
+
+	for (y = 0; y < IMAGE_HEIGHT; y++) {
+		guint8 *p = gdk_pixbuf_get_pixels (image) +
+			    y * gdk_pixbuf_get_rowstride (image);
+
+		for (x = 0; x < IMAGE_WIDTH; x++) {
+			int noise = g_rand_int_range (rand, -16, 16);
+
+			p[0] = CLAMP (x * 255 / IMAGE_WIDTH + noise, 0, 255);
+			p[1] = CLAMP (y * 255 / IMAGE_HEIGHT + noise, 0, 255);
+			p[2] = CLAMP (128 + noise, 0, 255);
+
+			p += 3;
+		}
+	}
+
+	g_rand_free (rand);
+
+	ok = gdk_pixbuf_save (image, filename, "jpeg", NULL,
+			      "quality", "90", NULL);
+	g_object_unref (image);
+
+	return ok;
+}
+
+/* Runs in the child; exits with 0 if every cover came out right */
+static void
+run_method (const Method *method, const char *filename)
+{
+	GTimer *timer;
+	double elapsed;
+	gboolean ok = TRUE;
+	int i;
+
+	timer = g_timer_new ();
+
+	for (i = 0; i < N_DECODES; i++) {
+		GdkPixbuf *cover = method->decode (filename);
+
+		if (method->decode == decode_nothing)
+			continue;
+
+		if (cover == NULL) {
+			ok = FALSE;
+			continue;
+		}
+
+		if (MAX (gdk_pixbuf_get_width (cover),
+			 gdk_pixbuf_get_height (cover)) != TARGET_SIZE)
+			ok = FALSE;
+
+		g_object_unref (cover);
+	}
+
+	elapsed = g_timer_elapsed (timer, NULL);
+	g_timer_destroy (timer);
+
+	if (method->decode != decode_nothing)
+		printf ("%-8s %8.1f ms per cover\n", method->name,
+			elapsed * 1e3 / N_DECODES);
+
+	fflush (stdout);
+
+	_exit (ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/* Returns the peak RSS of the child in kB, or -1 */
+static long
+measure (const Method *method, const char *filename)
+{
+	struct rusage usage;
+	pid_t pid;
+	int status;
+
+	fflush (stdout);
+
+	pid = fork ();
+	if (pid < 0)
+		return -1;
+
+	if (pid == 0)
+		run_method (method, filename);
+
+	if (wait4 (pid, &status, 0, &usage) != pid)
+		return -1;
+
+	if (!WIFEXITED (status) || WEXITSTATUS (status) != EXIT_SUCCESS) {
+		n_failures++;
+		fprintf (stderr, "FAIL: %s: wrong cover size\n", method->name);
+	}
+
+	return usage.ru_maxrss;
+}
+
+int
+main (void)
+{
+	long peaks[G_N_ELEMENTS (methods)];
+	char *dir, *filename;
+	guint i;
+
+#if !GLIB_CHECK_VERSION (2, 36, 0)
+	g_type_init ();
+#endif
+
+	dir = g_build_filename (g_get_tmp_dir (),
+				"muine-cover-decode-test-XXXXXX", NULL);
+	if (mkdtemp (dir) == NULL) {
+		fprintf (stderr, "FAIL: can't make %s\n", dir);
+		return EXIT_FAILURE;
+	}
+
+	filename = g_build_filename (dir, "cover.jpg", NULL);
+
+	if (!write_image (filename)) {
+		printf ("cover-decode-test: can't save JPEG, skipped\n");
+
+		g_rmdir (dir);
+		return EXIT_SKIP;
+	}
+
+	printf ("%dx%d JPEG to %d pixels\n",
+		IMAGE_WIDTH, IMAGE_HEIGHT, TARGET_SIZE);
+
+	for (i = 0; i < G_N_ELEMENTS (methods); i++) {
+		peaks[i] = measure (&methods[i], filename);
+
+		check (peaks[i] >= 0, "can't run the child");
+	}
+
+	/* methods[0] is the baseline */
+	for (i = 1; i < G_N_ELEMENTS (methods); i++)
+		printf ("%-8s %8ld kB peak\n", methods[i].name,
+			peaks[i] - peaks[0]);
+
+	check (peaks[2] < peaks[1], "decoding at size doesn't peak lower");
+
+	g_unlink (filename);
+	g_free (filename);
+
+	g_rmdir (dir);
+	g_free (dir);
+
+	printf ("cover-decode-test: %d failed\n", n_failures);
+
+	return (n_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
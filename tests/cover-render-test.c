@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Checks that the SSSE3 and AVX2 swizzles in cover-render.c give the
+ * same bytes as swizzle_scalar for every row width up to a few vectors,
+ * odd ones included, and don't write past the end of the row. Then
+ * prints how many covers per second each swizzle and cover_round_off
+ * get through.
+ *
+ * The swizzles are static, so cover-render.c is built into the test
+ * rather than linked from libmuine. The ones the CPU can't run are
+ * skipped.
+ */
+
+#include "cover-render.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* CoverDatabase.CoverSize */
+#define COVER_SIZE 66
+
+/* Several AVX2 vectors, and every tail length after them */
+#define MAX_WIDTH 67
+
+#define GUARD      0x5a
+#define GUARD_SIZE 32
+
+#define N_SWIZZLE_COVERS 20000
+#define N_ROUND_COVERS   2000
+
+typedef struct {
+	const char *name;
+	SwizzleFunc swizzle;
+	const char *cpu_feature;
+} Swizzle;
+
+static const Swizzle swizzles[] = {
+	{ "scalar", swizzle_scalar, NULL    },
+#ifdef HAVE_X86_SIMD
+	{ "ssse3",  swizzle_ssse3,  "ssse3" },
+	{ "avx2",   swizzle_avx2,   "avx2"  },
+#endif
+};
+
+static int n_failures = 0;
+
+static void
+check (gboolean condition, const char *swizzle, int width,
+       const char *message)
+{
+	if (condition)
+		return;
+
+	n_failures++;
+
+	fprintf (stderr, "FAIL: %s, width %d: %s\n", swizzle, width, message);
+}
+
+static gboolean
+supported (const Swizzle *swizzle)
+{
+	if (swizzle->cpu_feature == NULL)
+		return TRUE;
+
+#ifdef HAVE_X86_SIMD
+	__builtin_cpu_init ();
+
+	if (strcmp (swizzle->cpu_feature, "avx2") == 0)
+		return __builtin_cpu_supports ("avx2");
+	if (strcmp (swizzle->cpu_feature, "ssse3") == 0)
+		return __builtin_cpu_supports ("ssse3");
+#endif
+
+	return FALSE;
+}
+
+static void
+compare (const Swizzle *swizzle, const guint8 *src)
+{
+	guint8 expected[MAX_WIDTH * 4];
+	guint8 dst[MAX_WIDTH * 4 + GUARD_SIZE];
+	int width, offset, i;
+
+	for (width = 0; width <= MAX_WIDTH; width++) {
+		/* Rows of a cairo surface are aligned, pixbuf rows needn't
+		 * be, so move the source off alignment too */
+		for (offset = 0; offset < 4; offset++) {
+			const guint8 *s = src + offset * 4;
+			gboolean guard_ok = TRUE;
+
+			swizzle_scalar (s, expected, width);
+
+			memset (dst, GUARD, sizeof (dst));
+			swizzle->swizzle (s, dst + offset, width);
+
+			check (memcmp (dst + offset, expected, width * 4) == 0,
+			       swizzle->name, width, "differs from scalar");
+
+			for (i = 0; i < offset; i++)
+				guard_ok = guard_ok && dst[i] == GUARD;
+			for (i = offset + width * 4; i < (int) sizeof (dst); i++)
+				guard_ok = guard_ok && dst[i] == GUARD;
+
+			check (guard_ok, swizzle->name, width,
+			       "writes outside the row");
+		}
+	}
+}
+
+static void
+benchmark_swizzle (const Swizzle *swizzle, const guint8 *src)
+{
+	guint8 dst[COVER_SIZE * 4];
+	GTimer *timer;
+	double elapsed;
+	int i, row;
+
+	timer = g_timer_new ();
+
+	for (i = 0; i < N_SWIZZLE_COVERS; i++) {
+		for (row = 0; row < COVER_SIZE; row++)
+			swizzle->swizzle (src + row * COVER_SIZE * 4, dst,
+					  COVER_SIZE);
+	}
+
+	elapsed = g_timer_elapsed (timer, NULL);
+	g_timer_destroy (timer);
+
+	printf ("swizzle %-8s %12.0f covers/s\n", swizzle->name,
+		N_SWIZZLE_COVERS / elapsed);
+}
+
+static void
+benchmark_round_off (void)
+{
+	GdkPixbuf *cover;
+	GTimer *timer;
+	double elapsed;
+	int i;
+
+	cover = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8,
+				COVER_SIZE, COVER_SIZE);
+	gdk_pixbuf_fill (cover, 0x8040c0ff);
+
+	timer = g_timer_new ();
+
+	for (i = 0; i < N_ROUND_COVERS; i++) {
+		GdkPixbuf *output = cover_round_off (cover);
+
+		if (i == 0) {
+			check (gdk_pixbuf_get_width (output) == COVER_SIZE &&
+			       gdk_pixbuf_get_height (output) == COVER_SIZE &&
+			       gdk_pixbuf_get_has_alpha (output),
+			       "round off", COVER_SIZE, "wrong output");
+		}
+
+		g_object_unref (output);
+	}
+
+	elapsed = g_timer_elapsed (timer, NULL);
+	g_timer_destroy (timer);
+
+	printf ("cover_round_off  %12.0f covers/s\n",
+		N_ROUND_COVERS / elapsed);
+
+	g_object_unref (cover);
+}
+
+int
+main (void)
+{
+	guint8 *src;
+	GRand *rand;
+	int len, i;
+	guint j;
+
+#if !GLIB_CHECK_VERSION (2, 36, 0)
+	g_type_init ();
+#endif
+
+	/* Enough for a cover, which is more than a row at any offset */
+	len = COVER_SIZE * COVER_SIZE * 4;
+	src = g_malloc (len);
+
+	/* Same pixels every run */
+	rand = g_rand_new_with_seed (44);
+	for (i = 0; i < len; i++)
+		src[i] = g_rand_int_range (rand, 0, 256);
+	g_rand_free (rand);
+
+	for (j = 0; j < G_N_ELEMENTS (swizzles); j++) {
+		if (!supported (&swizzles[j])) {
+			printf ("swizzle %-8s not supported, skipped\n",
+				swizzles[j].name);
+			continue;
+		}
+
+		compare (&swizzles[j], src);
+		benchmark_swizzle (&swizzles[j], src);
+	}
+
+	benchmark_round_off ();
+
+	g_free (src);
+
+	printf ("cover-render-test: %d failed\n", n_failures);
+
+	return (n_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
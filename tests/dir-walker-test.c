@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Walks a large generated music tree with DirWalker, and with a plain
+ * recursive walk which stats every entry, the way the import walk
+ * worked before. Checks that both find the same music files, and that
+ * a symlink back up the tree doesn't make the walker read anything
+ * twice, and prints how long each walk takes.
+ */
+
+#include <config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "dir-walker.h"
+#include "macros.h"
+
+/* Artists, albums per artist and files per album */
+#define N_ARTISTS 50
+#define N_ALBUMS  20
+#define N_FILES   16
+
+/* Every N_FILES files, the ones which aren't music */
+static const char *other_files[] = {
+	"cover.jpg",
+	"folder.jpg",
+	"album.cue",
+	"info.txt"
+};
+
+#define N_WALKS 5
+
+/* Paths handed out per dir_walker_next_batch call, as in
+ * DirectoryWalker */
+#define BATCH_SIZE 256
+
+static int n_failures = 0;
+
+static void
+check (gboolean condition, const char *message)
+{
+	if (condition)
+		return;
+
+	n_failures++;
+
+	fprintf (stderr, "FAIL: %s\n", message);
+}
+
+static void
+touch (const char *dir, const char *name)
+{
+	char *filename;
+	FILE *file;
+
+	filename = g_build_filename (dir, name, NULL);
+
+	file = fopen (filename, "w");
+	if (file)
+		fclose (file);
+
+	g_free (filename);
+}
+
+/* Returns the number of music files made */
+static int
+make_tree (const char *root)
+{
+	char *loop;
+	int n_music = 0;
+	int i, j, k;
+
+	for (i = 0; i < N_ARTISTS; i++) {
+		char *artist_name, *artist;
+
+		artist_name = g_strdup_printf ("Artist %02d", i);
+		artist = g_build_filename (root, artist_name, NULL);
+		g_mkdir (artist, 0755);
+
+		for (j = 0; j < N_ALBUMS; j++) {
+			char *album_name, *album;
+			guint l;
+
+			album_name = g_strdup_printf ("Album %02d", j);
+			album = g_build_filename (artist, album_name, NULL);
+			g_mkdir (album, 0755);
+
+			for (k = 0; k < N_FILES; k++) {
+				char *track;
+
+				track = g_strdup_printf ("%02d - Track.%s", k + 1,
+							 (k % 2) ? "ogg" : "mp3");
+				touch (album, track);
+				g_free (track);
+
+				n_music++;
+			}
+
+			for (l = 0; l < G_N_ELEMENTS (other_files); l++)
+				touch (album, other_files[l]);
+
+			g_free (album);
+			g_free (album_name);
+		}
+
+		g_free (artist);
+		g_free (artist_name);
+	}
+
+	/* Back to the root, which the walker must not read again */
+	loop = g_build_filename (root, "Artist 00", "Everything", NULL);
+	check (symlink (root, loop) == 0, "can't make symlink");
+	g_free (loop);
+
+	return n_music;
+}
+
+static void
+remove_tree (const char *path)
+{
+	struct stat buf;
+	GDir *dir;
+	const char *name;
+
+	if (g_lstat (path, &buf) != 0)
+		return;
+
+	if (!S_ISDIR (buf.st_mode)) {
+		g_unlink (path);
+		return;
+	}
+
+	dir = g_dir_open (path, 0, NULL);
+	if (dir) {
+		while ((name = g_dir_read_name (dir)) != NULL) {
+			char *child = g_build_filename (path, name, NULL);
+
+			remove_tree (child);
+			g_free (child);
+		}
+
+		g_dir_close (dir);
+	}
+
+	g_rmdir (path);
+}
+
+static void
+walk_with_stat (const char *path, GHashTable *found)
+{
+	GDir *dir;
+	const char *name;
+
+	dir = g_dir_open (path, 0, NULL);
+	if (dir == NULL)
+		return;
+
+	while ((name = g_dir_read_name (dir)) != NULL) {
+		struct stat buf;
+		char *child;
+
+		child = g_build_filename (path, name, NULL);
+
+		/* Not following symlinks keeps this out of the loop */
+		if (g_lstat (child, &buf) != 0) {
+			g_free (child);
+			continue;
+		}
+
+		if (S_ISDIR (buf.st_mode)) {
+			walk_with_stat (child, found);
+			g_free (child);
+
+		} else if (S_ISREG (buf.st_mode) &&
+			   dir_walker_is_audio_file (name)) {
+			g_hash_table_insert (found, child, child);
+
+		} else {
+			g_free (child);
+		}
+	}
+
+	g_dir_close (dir);
+}
+
+/* Returns the number of paths handed out, counting duplicates */
+static int
+walk_with_walker (const char *root, GHashTable *found)
+{
+	DirWalker *walker;
+	char *batch;
+	int length;
+	int n = 0;
+
+	walker = dir_walker_new (root);
+
+	while ((batch = dir_walker_next_batch (walker, BATCH_SIZE,
+					       &length)) != NULL) {
+		char *path = batch;
+
+		while (path < batch + length) {
+			char *copy = g_strdup (path);
+
+			g_hash_table_insert (found, copy, copy);
+			n++;
+
+			path += strlen (path) + 1;
+		}
+
+		g_free (batch);
+	}
+
+	dir_walker_free (walker);
+
+	return n;
+}
+
+static void
+check_same (gpointer key, gpointer UNUSED(value), gpointer user_data)
+{
+	GHashTable *other = user_data;
+
+	if (g_hash_table_lookup (other, key) == NULL) {
+		n_failures++;
+		fprintf (stderr, "FAIL: only the stat walk found %s\n",
+			 (char *) key);
+	}
+}
+
+int
+main (void)
+{
+	GHashTable *by_walker = NULL, *by_stat = NULL;
+	double walker_time = G_MAXDOUBLE, stat_time = G_MAXDOUBLE;
+	char *root;
+	int n_music, n_handed_out = 0;
+	int i;
+
+	root = g_build_filename (g_get_tmp_dir (),
+				 "muine-dir-walker-test-XXXXXX", NULL);
+	if (mkdtemp (root) == NULL) {
+		fprintf (stderr, "FAIL: can't make %s\n", root);
+		return EXIT_FAILURE;
+	}
+
+	n_music = make_tree (root);
+
+	/* The first walk of each fills the page cache, so take the
+	 * fastest one */
+	for (i = 0; i < N_WALKS; i++) {
+		GTimer *timer;
+		double elapsed;
+
+		if (by_walker)
+			g_hash_table_destroy (by_walker);
+
+		by_walker = g_hash_table_new_full (g_str_hash, g_str_equal,
+						   g_free, NULL);
+
+		timer = g_timer_new ();
+		n_handed_out = walk_with_walker (root, by_walker);
+		elapsed = g_timer_elapsed (timer, NULL);
+		g_timer_destroy (timer);
+
+		walker_time = MIN (walker_time, elapsed);
+
+		if (by_stat)
+			g_hash_table_destroy (by_stat);
+
+		by_stat = g_hash_table_new_full (g_str_hash, g_str_equal,
+						 g_free, NULL);
+
+		timer = g_timer_new ();
+		walk_with_stat (root, by_stat);
+		elapsed = g_timer_elapsed (timer, NULL);
+		g_timer_destroy (timer);
+
+		stat_time = MIN (stat_time, elapsed);
+	}
+
+	check ((int) g_hash_table_size (by_stat) == n_music,
+	       "stat walk didn't find every music file");
+	check ((int) g_hash_table_size (by_walker) == n_music,
+	       "walker didn't find every music file");
+	check (n_handed_out == n_music,
+	       "walker handed out files twice");
+
+	g_hash_table_foreach (by_stat, check_same, by_walker);
+
+	printf ("%d music files, %d directories\n",
+		n_music, N_ARTISTS * (N_ALBUMS + 1) + 1);
+	printf ("walker    %8.1f ms %10.0f files/s\n", walker_time * 1e3,
+		n_music / walker_time);
+	printf ("stat walk %8.1f ms %10.0f files/s\n", stat_time * 1e3,
+		n_music / stat_time);
+
+	g_hash_table_destroy (by_walker);
+	g_hash_table_destroy (by_stat);
+
+	remove_tree (root);
+	g_free (root);
+
+	printf ("dir-walker-test: %d failed\n", n_failures);
+
+	return (n_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,410 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Plays a song from disk into a fakesink, in real time and with little
+ * buffered, while import threads read a pile of other files. Counts how
+ * often the buffer ran dry, and how long playback took beyond the
+ * length of the song, with the import threads at the default I/O
+ * priority and in the idle class, as ImportScheduler puts them.
+ *
+ * The files are dropped from the page cache before every run, so they
+ * have to come from the disk. On a file system without one, like
+ * tmpfs, there is nothing to compete for and both runs should be clean.
+ * Set TMPDIR to put the files on the disk to measure.
+ *
+ * Exits with 77, which automake counts as skipped, if the GStreamer
+ * elements aren't there.
+ */
+
+#include <config.h>
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+
+#include "io-priority.h"
+#include "macros.h"
+
+#define EXIT_SKIP 77
+
+/* The song: 16 bit stereo at 44.1 kHz */
+#define RATE          44100
+#define SONG_SECONDS  8
+
+/* What the queue may hold before the sink; less than a disk seek
+ * under load */
+#define QUEUE_TIME (100 * GST_MSECOND)
+
+/* The import */
+#define N_IMPORT_THREADS 8
+#define N_IMPORT_FILES   64
+#define IMPORT_FILE_SIZE (4 * 1024 * 1024)
+#define READ_SIZE        (64 * 1024)
+
+#define IOPRIO_CLASS_SHIFT 13
+#define IOPRIO_CLASS_IDLE  3
+
+typedef struct {
+	char **files;
+	int next;
+	volatile gboolean stop;
+	gboolean idle;
+	pthread_mutex_t lock;
+	int n_read;
+	int n_idle;     /* threads which went into the idle class */
+	int n_not_idle; /* reads done by those outside of it */
+} Import;
+
+static int n_failures = 0;
+
+static void
+check (gboolean condition, const char *message)
+{
+	if (condition)
+		return;
+
+	n_failures++;
+
+	fprintf (stderr, "FAIL: %s\n", message);
+}
+
+static gboolean
+write_file (const char *filename, const void *header, int header_len,
+	    int size, unsigned int seed)
+{
+	guint8 buf[READ_SIZE];
+	FILE *file;
+	int written = 0;
+
+	file = fopen (filename, "wb");
+	if (file == NULL)
+		return FALSE;
+
+	if (header_len > 0) {
+		fwrite (header, 1, header_len, file);
+		written = header_len;
+	}
+
+	/* Noise, so no file system can store it cheaply */
+	while (written < size) {
+		int n = MIN (size - written, (int) sizeof (buf));
+		int i;
+
+		for (i = 0; i < n; i++) {
+			seed = seed * 1103515245 + 12345;
+			buf[i] = seed >> 16;
+		}
+
+		fwrite (buf, 1, n, file);
+		written += n;
+	}
+
+	fflush (file);
+	fdatasync (fileno (file));
+	fclose (file);
+
+	return TRUE;
+}
+
+static void
+put_le (guint8 *p, guint32 value, int n_bytes)
+{
+	int i;
+
+	for (i = 0; i < n_bytes; i++)
+		p[i] = (value >> (8 * i)) & 0xff;
+}
+
+static gboolean
+write_song (const char *filename)
+{
+	guint8 header[44];
+	guint32 data_len = SONG_SECONDS * RATE * 4;
+
+	memcpy (header, "RIFF", 4);
+	put_le (header + 4, 36 + data_len, 4);
+	memcpy (header + 8, "WAVEfmt ", 8);
+	put_le (header + 16, 16, 4);          /* fmt chunk size */
+	put_le (header + 20, 1, 2);           /* PCM */
+	put_le (header + 22, 2, 2);           /* channels */
+	put_le (header + 24, RATE, 4);
+	put_le (header + 28, RATE * 4, 4);    /* bytes per second */
+	put_le (header + 32, 4, 2);           /* bytes per frame */
+	put_le (header + 34, 16, 2);          /* bits per sample */
+	memcpy (header + 36, "data", 4);
+	put_le (header + 40, data_len, 4);
+
+	return write_file (filename, header, sizeof (header),
+			   sizeof (header) + data_len, 1);
+}
+
+static void
+drop_from_cache (const char *filename)
+{
+	int fd;
+
+	fd = open (filename, O_RDONLY);
+	if (fd < 0)
+		return;
+
+	posix_fadvise (fd, 0, 0, POSIX_FADV_DONTNEED);
+	close (fd);
+}
+
+static void *
+import_thread (void *data)
+{
+	Import *import = data;
+	gboolean idle = FALSE;
+	guint8 *buf;
+
+	/* Fails where the kernel has no I/O priorities */
+	if (import->idle && io_priority_set_idle ()) {
+		idle = TRUE;
+
+		pthread_mutex_lock (&import->lock);
+		import->n_idle++;
+		pthread_mutex_unlock (&import->lock);
+	}
+
+	buf = g_malloc (READ_SIZE);
+
+	/* Reads every file in full, which is more than the tag readers
+	 * do, and goes round again until playback is done */
+	while (!import->stop) {
+		const char *filename;
+		int fd;
+
+		pthread_mutex_lock (&import->lock);
+
+		filename = import->files[import->next];
+		import->next = (import->next + 1) % N_IMPORT_FILES;
+
+		if (idle &&
+		    (io_priority_get () >> IOPRIO_CLASS_SHIFT) != IOPRIO_CLASS_IDLE)
+			import->n_not_idle++;
+
+		pthread_mutex_unlock (&import->lock);
+
+		drop_from_cache (filename);
+
+		fd = open (filename, O_RDONLY);
+		if (fd < 0)
+			continue;
+
+		while (!import->stop && read (fd, buf, READ_SIZE) > 0)
+			;
+
+		close (fd);
+
+		pthread_mutex_lock (&import->lock);
+		import->n_read++;
+		pthread_mutex_unlock (&import->lock);
+	}
+
+	g_free (buf);
+
+	return NULL;
+}
+
+static void
+underrun_cb (GstElement *UNUSED(queue), int *n_underruns)
+{
+	g_atomic_int_inc (n_underruns);
+}
+
+/* Returns FALSE if playback failed */
+static gboolean
+play (const char *song, char **files, gboolean idle, gboolean with_import)
+{
+	GstElement *pipeline, *src, *queue;
+	GstMessage *message;
+	GTimer *timer;
+	Import import;
+	pthread_t threads[N_IMPORT_THREADS];
+	char *description;
+	double elapsed;
+	int n_underruns = 0;
+	int n_threads = 0;
+	int i;
+
+	description = g_strdup_printf
+		("filesrc name=src ! wavparse ! "
+		 "queue name=queue max-size-buffers=0 max-size-bytes=0 "
+		 "max-size-time=%" G_GUINT64_FORMAT " ! "
+		 "fakesink sync=true", (guint64) QUEUE_TIME);
+
+	pipeline = gst_parse_launch (description, NULL);
+	g_free (description);
+
+	if (pipeline == NULL)
+		return FALSE;
+
+	src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+	g_object_set (src, "location", song, NULL);
+	gst_object_unref (src);
+
+	queue = gst_bin_get_by_name (GST_BIN (pipeline), "queue");
+
+	drop_from_cache (song);
+
+	memset (&import, 0, sizeof (import));
+	import.files = files;
+	import.idle = idle;
+	pthread_mutex_init (&import.lock, NULL);
+
+	if (with_import) {
+		for (i = 0; i < N_IMPORT_THREADS; i++) {
+			if (pthread_create (&threads[n_threads], NULL,
+					    import_thread, &import) == 0)
+				n_threads++;
+		}
+
+		/* Let the import get going first */
+		g_usleep (G_USEC_PER_SEC / 2);
+	}
+
+	/* Buffering before playing starts doesn't count */
+	gst_element_set_state (pipeline, GST_STATE_PAUSED);
+	gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+	g_signal_connect (queue, "underrun",
+			  G_CALLBACK (underrun_cb), &n_underruns);
+
+	timer = g_timer_new ();
+
+	gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+	message = gst_bus_poll (gst_element_get_bus (pipeline),
+				GST_MESSAGE_EOS | GST_MESSAGE_ERROR,
+				(SONG_SECONDS * 4) * GST_SECOND);
+
+	elapsed = g_timer_elapsed (timer, NULL);
+	g_timer_destroy (timer);
+
+	import.stop = TRUE;
+	for (i = 0; i < n_threads; i++)
+		pthread_join (threads[i], NULL);
+
+	gst_element_set_state (pipeline, GST_STATE_NULL);
+
+	printf ("%-14s %4d underruns %8.0f ms late %6d files read\n",
+		!with_import ? "no import" :
+		idle ? "idle import" : "default import",
+		n_underruns, (elapsed - SONG_SECONDS) * 1e3, import.n_read);
+
+	if (with_import && idle) {
+		if (import.n_idle == 0)
+			printf ("no I/O priorities, idle import is default\n");
+
+		check (import.n_not_idle == 0,
+		       "import threads left the idle class");
+	}
+
+	pthread_mutex_destroy (&import.lock);
+	gst_object_unref (queue);
+	gst_object_unref (pipeline);
+
+	if (message == NULL)
+		return FALSE;
+
+	if (GST_MESSAGE_TYPE (message) != GST_MESSAGE_EOS) {
+		gst_message_unref (message);
+		return FALSE;
+	}
+
+	gst_message_unref (message);
+
+	return TRUE;
+}
+
+int
+main (int argc, char *argv[])
+{
+	GstElement *parse;
+	char *dir, *song;
+	char *files[N_IMPORT_FILES];
+	int i;
+
+	gst_init (&argc, &argv);
+
+	parse = gst_element_factory_make ("wavparse", NULL);
+	if (parse == NULL) {
+		printf ("import-underrun-test: no wavparse, skipped\n");
+		return EXIT_SKIP;
+	}
+
+	gst_object_unref (parse);
+
+	dir = g_build_filename (g_get_tmp_dir (),
+				"muine-import-underrun-test-XXXXXX", NULL);
+	if (mkdtemp (dir) == NULL) {
+		fprintf (stderr, "FAIL: can't make %s\n", dir);
+		return EXIT_FAILURE;
+	}
+
+	song = g_build_filename (dir, "song.wav", NULL);
+	check (write_song (song), "can't write the song");
+
+	for (i = 0; i < N_IMPORT_FILES; i++) {
+		char *name = g_strdup_printf ("import-%02d.mp3", i);
+
+		files[i] = g_build_filename (dir, name, NULL);
+		g_free (name);
+
+		check (write_file (files[i], NULL, 0, IMPORT_FILE_SIZE, i + 2),
+		       "can't write the import files");
+	}
+
+	if (n_failures == 0) {
+		check (play (song, files, FALSE, FALSE),
+		       "playback without import failed");
+		check (play (song, files, FALSE, TRUE),
+		       "playback with default import failed");
+		check (play (song, files, TRUE, TRUE),
+		       "playback with idle import failed");
+	}
+
+	for (i = 0; i < N_IMPORT_FILES; i++) {
+		g_unlink (files[i]);
+		g_free (files[i]);
+	}
+
+	g_unlink (song);
+	g_free (song);
+
+	g_rmdir (dir);
+	g_free (dir);
+
+	printf ("import-underrun-test: %d failed\n", n_failures);
+
+	return (n_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
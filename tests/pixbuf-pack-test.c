@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2026 Jorn Baayen <jorn.baayen@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Compares the ways covers are stored in covers.db: PNG at compression
+ * 9, which db_pack_pixbuf writes, RLE pixdata, which it falls back to,
+ * and raw pixdata, which older versions wrote. For each, prints the
+ * record size and the time db_unpack_pixbuf takes, and checks that the
+ * cover comes back unchanged and that only raw pixdata is repacked.
+ *
+ * The covers are the images in data/images scaled to the cover size,
+ * and a noisy gradient, which is as bad as photos get for both PNG and
+ * RLE.
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <gdk-pixbuf/gdk-pixdata.h>
+
+#include "db.h"
+
+/* CoverDatabase.CoverSize */
+#define COVER_SIZE 66
+
+#define N_DECODES 200
+
+typedef gpointer (*PackFunc) (GdkPixbuf *pixbuf, int *len);
+
+typedef struct {
+	const char *name;
+	PackFunc pack;
+	gboolean needs_repack;
+} Format;
+
+static const char *images[] = {
+	"muine-default-cover.png",
+	"muine-cover-downloading.png",
+	"muine-about.png",
+	"muine-48.png"
+};
+
+static int n_failures = 0;
+
+static void
+check (gboolean condition, const char *cover, const char *format,
+       const char *message)
+{
+	if (condition)
+		return;
+
+	n_failures++;
+
+	fprintf (stderr, "FAIL: %s, %s: %s\n", cover, format, message);
+}
+
+static gpointer
+pack_png (GdkPixbuf *pixbuf, int *len)
+{
+	gpointer p = db_pack_start ();
+
+	db_pack_pixbuf (p, pixbuf);
+
+	return db_pack_end (p, len);
+}
+
+/* The same record layout as db_pack_pixbuf, with pixdata inside */
+static gpointer
+pack_pixdata (GdkPixbuf *pixbuf, gboolean use_rle, int *len)
+{
+	GdkPixdata pixdata;
+	gpointer rle, p;
+	guint8 *buf;
+	guint buf_len = 0;
+
+	rle = gdk_pixdata_from_pixbuf (&pixdata, pixbuf, use_rle);
+	buf = gdk_pixdata_serialize (&pixdata, &buf_len);
+	g_free (rle);
+
+	p = db_pack_start ();
+
+	db_pack_int (p, buf_len);
+	g_string_append_len ((GString *) p, (char *) buf, buf_len);
+	g_string_append_c ((GString *) p, 0);
+
+	g_free (buf);
+
+	return db_pack_end (p, len);
+}
+
+static gpointer
+pack_rle (GdkPixbuf *pixbuf, int *len)
+{
+	return pack_pixdata (pixbuf, TRUE, len);
+}
+
+static gpointer
+pack_raw (GdkPixbuf *pixbuf, int *len)
+{
+	return pack_pixdata (pixbuf, FALSE, len);
+}
+
+static const Format formats[] = {
+	{ "png", pack_png, FALSE },
+	{ "rle", pack_rle, FALSE },
+	{ "raw", pack_raw, TRUE  }
+};
+
+static gboolean
+same_pixels (GdkPixbuf *a, GdkPixbuf *b)
+{
+	int width, height, n_channels, y;
+
+	width = gdk_pixbuf_get_width (a);
+	height = gdk_pixbuf_get_height (a);
+	n_channels = gdk_pixbuf_get_n_channels (a);
+
+	if (gdk_pixbuf_get_width (b) != width ||
+	    gdk_pixbuf_get_height (b) != height ||
+	    gdk_pixbuf_get_n_channels (b) != n_channels)
+		return FALSE;
+
+	for (y = 0; y < height; y++) {
+		const guint8 *row_a, *row_b;
+
+		row_a = gdk_pixbuf_get_pixels (a) + y * gdk_pixbuf_get_rowstride (a);
+		row_b = gdk_pixbuf_get_pixels (b) + y * gdk_pixbuf_get_rowstride (b);
+
+		if (memcmp (row_a, row_b, width * n_channels) != 0)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static GdkPixbuf *
+load_cover (const char *dir, const char *name)
+{
+	GdkPixbuf *image, *cover;
+	char *filename;
+
+	filename = g_build_filename (dir, name, NULL);
+	image = gdk_pixbuf_new_from_file (filename, NULL);
+	g_free (filename);
+
+	if (image == NULL)
+		return NULL;
+
+	cover = gdk_pixbuf_scale_simple (image, COVER_SIZE, COVER_SIZE,
+					 GDK_INTERP_BILINEAR);
+	g_object_unref (image);
+
+	return cover;
+}
+
+static GdkPixbuf *
+noisy_cover (void)
+{
+	GdkPixbuf *cover;
+	GRand *rand;
+	int x, y;
+
+	cover = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8,
+				COVER_SIZE, COVER_SIZE);
+
+	/* Same pixels every run */
+	rand = g_rand_new_with_seed (41);
+
+	for (y = 0; y < COVER_SIZE; y++) {
+		guint8 *p = gdk_pixbuf_get_pixels (cover) +
+			    y * gdk_pixbuf_get_rowstride (cover);
+
+		for (x = 0; x < COVER_SIZE; x++) {
+			int noise = g_rand_int_range (rand, -16, 16);
+
+			p[0] = CLAMP (x * 255 / COVER_SIZE + noise, 0, 255);
+			p[1] = CLAMP (y * 255 / COVER_SIZE + noise, 0, 255);
+			p[2] = CLAMP (128 + noise, 0, 255);
+			p[3] = 255;
+
+			p += 4;
+		}
+	}
+
+	g_rand_free (rand);
+
+	return cover;
+}
+
+static void
+compare_formats (const char *name, GdkPixbuf *cover)
+{
+	int raw_len = 0;
+	int lens[G_N_ELEMENTS (formats)];
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+		const Format *format = &formats[i];
+		GdkPixbuf *decoded = NULL;
+		GTimer *timer;
+		gpointer record;
+		double elapsed;
+		int j;
+
+		record = format->pack (cover, &lens[i]);
+
+		db_unpack_pixbuf (record, &decoded);
+
+		check (decoded != NULL, name, format->name, "doesn't decode");
+		if (decoded == NULL) {
+			g_free (record);
+			continue;
+		}
+
+		check (same_pixels (cover, decoded), name, format->name,
+		       "decodes to different pixels");
+		g_object_unref (decoded);
+
+		check (db_pixbuf_needs_repack (record) == format->needs_repack,
+		       name, format->name,
+		       format->needs_repack ? "isn't repacked" : "is repacked");
+
+		timer = g_timer_new ();
+
+		for (j = 0; j < N_DECODES; j++) {
+			db_unpack_pixbuf (record, &decoded);
+			if (decoded)
+				g_object_unref (decoded);
+		}
+
+		elapsed = g_timer_elapsed (timer, NULL);
+		g_timer_destroy (timer);
+
+		printf ("%-28s %s %7d bytes %8.1f us\n", name, format->name,
+			lens[i], elapsed * 1e6 / N_DECODES);
+
+		if (format->needs_repack)
+			raw_len = lens[i];
+
+		g_free (record);
+	}
+
+	/* formats[0] is PNG */
+	check (lens[0] < raw_len, name, formats[0].name,
+	       "isn't smaller than raw pixdata");
+}
+
+int
+main (void)
+{
+	const char *srcdir;
+	char *dir;
+	GdkPixbuf *cover;
+	guint i;
+
+#if !GLIB_CHECK_VERSION (2, 36, 0)
+	g_type_init ();
+#endif
+
+	srcdir = g_getenv ("srcdir");
+	if (srcdir == NULL)
+		srcdir = ".";
+
+	dir = g_build_filename (srcdir, "..", "data", "images", NULL);
+
+	for (i = 0; i < G_N_ELEMENTS (images); i++) {
+		cover = load_cover (dir, images[i]);
+
+		check (cover != NULL, images[i], "-", "can't be loaded");
+		if (cover == NULL)
+			continue;
+
+		compare_formats (images[i], cover);
+		g_object_unref (cover);
+	}
+
+	g_free (dir);
+
+	cover = noisy_cover ();
+	compare_formats ("noise", cover);
+	g_object_unref (cover);
+
+	printf ("pixbuf-pack-test: %d failed\n", n_failures);
+
+	return (n_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}